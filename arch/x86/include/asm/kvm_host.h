@@ -1696,6 +1696,7 @@ struct kvm_vcpu_stat {
 	u64 preemption_other;
 	u64 guest_mode;
 	u64 notify_window_exits;
+	u64 dirty_ring_full_exits;
 };
 
 struct x86_instruction_info;
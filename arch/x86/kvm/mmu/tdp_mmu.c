@@ -1722,8 +1722,13 @@ static void clear_dirty_pt_masked(struct kvm *kvm, struct kvm_mmu_page *root,
 
 	rcu_read_lock();
 
+	/*
+	 * Bound the walk by the last GFN in @mask, not the end of the word:
+	 * set bits without a present SPTE would otherwise keep the walk going
+	 * to the end, through leaf SPTEs that were never asked about.
+	 */
 	tdp_root_for_each_leaf_pte(iter, kvm, root, gfn + __ffs(mask),
-				    gfn + BITS_PER_LONG) {
+				    gfn + __fls(mask) + 1) {
 		if (!mask)
 			break;
 
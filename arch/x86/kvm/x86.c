@@ -305,6 +305,7 @@ const struct kvm_stats_desc kvm_vcpu_stats_desc[] = {
 	STATS_DESC_COUNTER(VCPU, preemption_other),
 	STATS_DESC_IBOOLEAN(VCPU, guest_mode),
 	STATS_DESC_COUNTER(VCPU, notify_window_exits),
+	STATS_DESC_COUNTER(VCPU, dirty_ring_full_exits),
 };
 
 const struct kvm_stats_header kvm_vcpu_stats_header = {
@@ -11094,6 +11095,7 @@ static int vcpu_enter_guest(struct kvm_vcpu *vcpu)
 		}
 
 		if (kvm_dirty_ring_check_request(vcpu)) {
+			++vcpu->stat.dirty_ring_full_exits;
 			r = 0;
 			goto out;
 		}
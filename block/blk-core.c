@@ -671,9 +671,17 @@ static void __submit_bio(struct bio *bio)
 static void __submit_bio_noacct(struct bio *bio)
 {
 	struct bio_list bio_list_on_stack[2];
+	struct blk_plug plug;
 
 	BUG_ON(bio->bi_next);
 
+	/*
+	 * Keep a single plug across the whole loop, so that the bios a stacking
+	 * driver remaps to the lower devices are batched in one plug and can be
+	 * issued through ->queue_rqs() together, rather than being flushed one
+	 * by one by the plug in __submit_bio().
+	 */
+	blk_start_plug(&plug);
 	bio_list_init(&bio_list_on_stack[0]);
 	current->bio_list = bio_list_on_stack;
 
@@ -710,6 +718,7 @@ static void __submit_bio_noacct(struct bio *bio)
 	} while ((bio = bio_list_pop(&bio_list_on_stack[0])));
 
 	current->bio_list = NULL;
+	blk_finish_plug(&plug);
 }
 
 static void __submit_bio_noacct_mq(struct bio *bio)
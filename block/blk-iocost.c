@@ -44,7 +44,13 @@
  * /sys/fs/cgroup/io.cost.model.
  *
  * If needed, tools/cgroup/iocost_coef_gen.py can be used to generate
- * device-specific coefficients.
+ * device-specific coefficients.  Alternatively, "ctrl=calib" lets the
+ * controller calibrate the coefficients online.  A vrate which stays away
+ * from 100% for long means that the model is consistently off by that
+ * factor, so it gets folded into the coefficients and vrate is divided by
+ * it.  The total factor is kept within the QoS vrate range relative to the
+ * starting model, whatever doesn't fit stays in vrate.  Switching to
+ * "ctrl=user" freezes the calibrated model.
  *
  * 2. Control Strategy
  *
@@ -260,6 +266,14 @@ enum {
 
 	/* switch iff the conditions are met for longer than this */
 	AUTOP_CYCLE_NSEC	= 10LLU * NSEC_PER_SEC,
+
+	/*
+	 * Fold vrate into the calibrated cost model if it's been off by more
+	 * than the tolerance for a whole cycle, consider the model converged
+	 * if it's been within the tolerance for a whole cycle.
+	 */
+	CALIB_TOLERANCE_PCT	= 5,
+	CALIB_CYCLE_NSEC	= 10LLU * NSEC_PER_SEC,
 };
 
 enum {
@@ -445,6 +459,15 @@ struct ioc {
 	int				autop_idx;
 	bool				user_qos_params:1;
 	bool				user_cost_model:1;
+
+	/* online cost model calibration */
+	bool				calib_cost_model:1;
+	bool				calib_converged:1;
+	u64				calib_seed[NR_I_LCOEFS];
+	u64				calib_scale;
+	u64				calib_off_at;
+	u64				calib_on_at;
+	u32				calib_folds;
 };
 
 struct iocg_pcpu_stat {
@@ -990,6 +1013,77 @@ static void ioc_refresh_vrate(struct ioc *ioc, struct ioc_now *now)
 	ioc->vtime_err = clamp(ioc->vtime_err, -vperiod, vperiod);
 }
 
+/*
+ * With ctrl=calib, the cost model is refit from the vrate the QoS logic
+ * settles on.  Called from the period timer with ioc->lock held.
+ */
+static void ioc_calibrate_cost_model(struct ioc *ioc)
+{
+	u64 vrate = ioc->vtime_base_rate;
+	u64 *u = ioc->params.i_lcoefs;
+	u64 scale;
+	u32 vrate_pct;
+	u64 now_ns;
+	int i;
+
+	lockdep_assert_held(&ioc->lock);
+
+	if (!ioc->calib_cost_model)
+		return;
+
+	vrate_pct = div64_u64(vrate * 100, VTIME_PER_USEC);
+	now_ns = blk_time_get_ns();
+
+	if (abs((int)vrate_pct - 100) <= CALIB_TOLERANCE_PCT) {
+		ioc->calib_off_at = 0;
+		if (!ioc->calib_on_at)
+			ioc->calib_on_at = now_ns;
+		if (now_ns - ioc->calib_on_at >= CALIB_CYCLE_NSEC)
+			ioc->calib_converged = true;
+		return;
+	}
+
+	ioc->calib_on_at = 0;
+	if (!ioc->calib_off_at)
+		ioc->calib_off_at = now_ns;
+	if (now_ns - ioc->calib_off_at < CALIB_CYCLE_NSEC)
+		return;
+
+	/*
+	 * vrate > 100% means that the device completes more than the model
+	 * thinks it can, scale the capabilities up by the same factor and
+	 * vice-versa.  The folds accumulate relative to the seed model and
+	 * are kept within the vrate range allowed by the QoS parameters, so
+	 * that a misbehaving device can't walk the model arbitrarily far
+	 * away from it.  Whatever doesn't fit stays in vrate.
+	 */
+	scale = clamp(mul_u64_u64_div_u64(ioc->calib_scale, vrate,
+					  VTIME_PER_USEC),
+		      ioc->vrate_min, ioc->vrate_max);
+	if (scale == ioc->calib_scale) {
+		ioc->calib_off_at = 0;
+		return;
+	}
+
+	for (i = 0; i < NR_I_LCOEFS; i++) {
+		if (!ioc->calib_seed[i])
+			continue;
+		u[i] = mul_u64_u64_div_u64(ioc->calib_seed[i], scale,
+					   VTIME_PER_USEC);
+		u[i] = max_t(u64, u[i], 1);
+	}
+	ioc_refresh_lcoefs(ioc);
+
+	ioc->vtime_base_rate = mul_u64_u64_div_u64(vrate, ioc->calib_scale,
+						   scale);
+	ioc->calib_scale = scale;
+	ioc_refresh_margins(ioc);
+
+	ioc->calib_off_at = 0;
+	ioc->calib_converged = false;
+	ioc->calib_folds++;
+}
+
 static void ioc_adjust_base_vrate(struct ioc *ioc, u32 rq_wait_pct,
 				  int nr_lagging, int nr_shortages,
 				  int prev_busy_level, u32 *missed_ppm)
@@ -2439,6 +2533,8 @@ static void ioc_timer_fn(struct timer_list *timer)
 	ioc_adjust_base_vrate(ioc, rq_wait_pct, nr_lagging, nr_shortages,
 			      prev_busy_level, missed_ppm);
 
+	ioc_calibrate_cost_model(ioc);
+
 	ioc_refresh_params(ioc, false);
 
 	ioc_forgive_debts(ioc, usage_us_sum, nr_debtors, &now);
@@ -3056,6 +3152,10 @@ static void ioc_pd_stat(struct blkg_policy_data *pd, struct seq_file *s)
 			ioc->vtime_base_rate * 10000,
 			VTIME_PER_USEC);
 		seq_printf(s, " cost.vrate=%u.%02u", vp10k / 100, vp10k % 100);
+		if (ioc->calib_cost_model)
+			seq_printf(s, " cost.calib=%s cost.calib_folds=%u",
+				   ioc->calib_converged ? "converged" : "calibrating",
+				   ioc->calib_folds);
 	}
 
 	seq_printf(s, " cost.usage=%llu", iocg->last_stat.usage_us);
@@ -3371,7 +3471,8 @@ static u64 ioc_cost_model_prfill(struct seq_file *sf,
 	seq_printf(sf, "%s ctrl=%s model=linear "
 		   "rbps=%llu rseqiops=%llu rrandiops=%llu "
 		   "wbps=%llu wseqiops=%llu wrandiops=%llu\n",
-		   dname, ioc->user_cost_model ? "user" : "auto",
+		   dname, ioc->calib_cost_model ? "calib" :
+		   ioc->user_cost_model ? "user" : "auto",
 		   u[I_LCOEF_RBPS], u[I_LCOEF_RSEQIOPS], u[I_LCOEF_RRANDIOPS],
 		   u[I_LCOEF_WBPS], u[I_LCOEF_WSEQIOPS], u[I_LCOEF_WRANDIOPS]);
 	spin_unlock(&ioc->lock);
@@ -3411,7 +3512,7 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	unsigned int memflags;
 	struct ioc *ioc;
 	u64 u[NR_I_LCOEFS];
-	bool user;
+	bool user, calib, coefs = false;
 	char *body, *p;
 	int ret;
 
@@ -3442,6 +3543,7 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	spin_lock_irq(&ioc->lock);
 	memcpy(u, ioc->params.i_lcoefs, sizeof(u));
 	user = ioc->user_cost_model;
+	calib = ioc->calib_cost_model;
 
 	while ((p = strsep(&body, " \t\n"))) {
 		substring_t args[MAX_OPT_ARGS];
@@ -3455,12 +3557,19 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 		switch (match_token(p, cost_ctrl_tokens, args)) {
 		case COST_CTRL:
 			match_strlcpy(buf, &args[0], sizeof(buf));
-			if (!strcmp(buf, "auto"))
+			if (!strcmp(buf, "auto")) {
 				user = false;
-			else if (!strcmp(buf, "user"))
+				calib = false;
+			} else if (!strcmp(buf, "user")) {
 				user = true;
-			else
+				calib = false;
+			} else if (!strcmp(buf, "calib")) {
+				/* calibrate starting from the current model */
+				user = true;
+				calib = true;
+			} else {
 				goto einval;
+			}
 			continue;
 		case COST_MODEL:
 			match_strlcpy(buf, &args[0], sizeof(buf));
@@ -3476,6 +3585,7 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 			goto einval;
 		u[tok] = v;
 		user = true;
+		coefs = true;
 	}
 
 	if (user) {
@@ -3484,6 +3594,18 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	} else {
 		ioc->user_cost_model = false;
 	}
+	/* the model calibration starts from, explicitly written or current */
+	if (calib && (coefs || !ioc->calib_cost_model)) {
+		memcpy(ioc->calib_seed, u, sizeof(u));
+		ioc->calib_scale = VTIME_PER_USEC;
+	}
+	if (calib != ioc->calib_cost_model) {
+		ioc->calib_cost_model = calib;
+		ioc->calib_converged = false;
+		ioc->calib_off_at = 0;
+		ioc->calib_on_at = 0;
+		ioc->calib_folds = 0;
+	}
 	ioc_refresh_params(ioc, true);
 	spin_unlock_irq(&ioc->lock);
 
@@ -11,10 +11,38 @@
 #include "blk-mq.h"
 #include "blk.h"
 
+enum {
+	BLK_LAT_HIST_READ,
+	BLK_LAT_HIST_WRITE,
+	BLK_LAT_HIST_DISCARD,
+	BLK_LAT_HIST_FLUSH,
+	BLK_LAT_HIST_NR_OPS,
+};
+
+static const char *const blk_lat_hist_op_names[BLK_LAT_HIST_NR_OPS] = {
+	[BLK_LAT_HIST_READ]	= "read",
+	[BLK_LAT_HIST_WRITE]	= "write",
+	[BLK_LAT_HIST_DISCARD]	= "discard",
+	[BLK_LAT_HIST_FLUSH]	= "flush",
+};
+
+/*
+ * Completion latency histogram, bucket i counts completions that took
+ * [2^(i-1), 2^i) usecs, the first bucket sub-usec ones and the last bucket
+ * everything from 2^(BLK_LAT_HIST_BUCKETS-2) usecs (~4s) up.
+ */
+#define BLK_LAT_HIST_BUCKETS	24
+
+struct blk_lat_hist {
+	u64 nr[BLK_LAT_HIST_NR_OPS][BLK_LAT_HIST_BUCKETS];
+};
+
 struct blk_queue_stats {
 	struct list_head callbacks;
 	spinlock_t lock;
 	int accounting;
+	/* freed after an RCU grace period, see blk_stat_disable_lat_hist() */
+	struct blk_lat_hist __percpu *hist;
 };
 
 void blk_rq_stat_init(struct blk_rq_stat *stat)
@@ -47,6 +75,40 @@ void blk_rq_stat_add(struct blk_rq_stat *stat, u64 value)
 	stat->nr_samples++;
 }
 
+static int blk_lat_hist_op(const struct request *rq)
+{
+	switch (req_op(rq)) {
+	case REQ_OP_READ:
+		return BLK_LAT_HIST_READ;
+	case REQ_OP_WRITE:
+		return BLK_LAT_HIST_WRITE;
+	case REQ_OP_DISCARD:
+		return BLK_LAT_HIST_DISCARD;
+	case REQ_OP_FLUSH:
+		return BLK_LAT_HIST_FLUSH;
+	default:
+		return -1;
+	}
+}
+
+static void blk_lat_hist_add(struct blk_queue_stats *stats,
+			     const struct request *rq, u64 value)
+{
+	struct blk_lat_hist __percpu *hist = READ_ONCE(stats->hist);
+	int op;
+
+	if (!hist)
+		return;
+
+	op = blk_lat_hist_op(rq);
+	if (op < 0)
+		return;
+
+	this_cpu_inc(hist->nr[op][min_t(unsigned int,
+					fls64(div_u64(value, NSEC_PER_USEC)),
+					BLK_LAT_HIST_BUCKETS - 1)]);
+}
+
 void blk_stat_add(struct request *rq, u64 now)
 {
 	struct request_queue *q = rq->q;
@@ -58,6 +120,7 @@ void blk_stat_add(struct request *rq, u64 now)
 	value = (now >= rq->io_start_time_ns) ? now - rq->io_start_time_ns : 0;
 
 	rcu_read_lock();
+	blk_lat_hist_add(q->stats, rq, value);
 	cpu = get_cpu();
 	list_for_each_entry_rcu(cb, &q->stats->callbacks, list) {
 		if (!blk_stat_is_active(cb))
@@ -180,28 +243,137 @@ void blk_stat_free_callback(struct blk_stat_callback *cb)
 		call_rcu(&cb->rcu, blk_stat_free_callback_rcu);
 }
 
+/* Called with q->stats->lock held */
+static void __blk_stat_disable_accounting(struct request_queue *q)
+{
+	if (!--q->stats->accounting && list_empty(&q->stats->callbacks))
+		blk_queue_flag_clear(QUEUE_FLAG_STATS, q);
+}
+
 void blk_stat_disable_accounting(struct request_queue *q)
 {
 	unsigned long flags;
 
 	spin_lock_irqsave(&q->stats->lock, flags);
-	if (!--q->stats->accounting && list_empty(&q->stats->callbacks))
-		blk_queue_flag_clear(QUEUE_FLAG_STATS, q);
+	__blk_stat_disable_accounting(q);
 	spin_unlock_irqrestore(&q->stats->lock, flags);
 }
 EXPORT_SYMBOL_GPL(blk_stat_disable_accounting);
 
+/* Called with q->stats->lock held */
+static void __blk_stat_enable_accounting(struct request_queue *q)
+{
+	if (!q->stats->accounting++ && list_empty(&q->stats->callbacks))
+		blk_queue_flag_set(QUEUE_FLAG_STATS, q);
+}
+
 void blk_stat_enable_accounting(struct request_queue *q)
 {
 	unsigned long flags;
 
 	spin_lock_irqsave(&q->stats->lock, flags);
-	if (!q->stats->accounting++ && list_empty(&q->stats->callbacks))
-		blk_queue_flag_set(QUEUE_FLAG_STATS, q);
+	__blk_stat_enable_accounting(q);
 	spin_unlock_irqrestore(&q->stats->lock, flags);
 }
 EXPORT_SYMBOL_GPL(blk_stat_enable_accounting);
 
+/**
+ * blk_stat_enable_lat_hist() - Start collecting the completion latency
+ * histogram of a request queue.
+ * @q: The request queue.
+ *
+ * Return: 0 on success (or if already enabled), -ENOMEM otherwise.
+ */
+int blk_stat_enable_lat_hist(struct request_queue *q)
+{
+	struct blk_lat_hist __percpu *hist;
+	unsigned long flags;
+
+	if (READ_ONCE(q->stats->hist))
+		return 0;
+
+	hist = alloc_percpu(struct blk_lat_hist);
+	if (!hist)
+		return -ENOMEM;
+
+	/*
+	 * Publish the histogram and take its accounting reference in one go,
+	 * so that a concurrent disable can't drop a reference not taken yet.
+	 */
+	spin_lock_irqsave(&q->stats->lock, flags);
+	if (q->stats->hist) {
+		spin_unlock_irqrestore(&q->stats->lock, flags);
+		free_percpu(hist);
+		return 0;
+	}
+	/* Paired with READ_ONCE() in blk_lat_hist_add() */
+	smp_store_release(&q->stats->hist, hist);
+	__blk_stat_enable_accounting(q);
+	spin_unlock_irqrestore(&q->stats->lock, flags);
+
+	return 0;
+}
+
+/**
+ * blk_stat_disable_lat_hist() - Stop collecting the completion latency
+ * histogram of a request queue and discard it.
+ * @q: The request queue.
+ */
+void blk_stat_disable_lat_hist(struct request_queue *q)
+{
+	struct blk_lat_hist __percpu *hist;
+	unsigned long flags;
+
+	spin_lock_irqsave(&q->stats->lock, flags);
+	hist = q->stats->hist;
+	if (hist) {
+		WRITE_ONCE(q->stats->hist, NULL);
+		__blk_stat_disable_accounting(q);
+	}
+	spin_unlock_irqrestore(&q->stats->lock, flags);
+
+	if (!hist)
+		return;
+
+	synchronize_rcu();
+	free_percpu(hist);
+}
+
+/**
+ * blk_stat_show_lat_hist() - Format the completion latency histogram of a
+ * request queue, one line per operation.
+ * @q: The request queue.
+ * @page: Output buffer, one page.
+ *
+ * Return: Number of bytes written.
+ */
+ssize_t blk_stat_show_lat_hist(struct request_queue *q, char *page)
+{
+	struct blk_lat_hist __percpu *hist;
+	ssize_t len = 0;
+	int op, i, cpu;
+
+	rcu_read_lock();
+	hist = READ_ONCE(q->stats->hist);
+	if (!hist)
+		goto out;
+
+	for (op = 0; op < BLK_LAT_HIST_NR_OPS; op++) {
+		len += sysfs_emit_at(page, len, "%s", blk_lat_hist_op_names[op]);
+		for (i = 0; i < BLK_LAT_HIST_BUCKETS; i++) {
+			u64 sum = 0;
+
+			for_each_possible_cpu(cpu)
+				sum += per_cpu_ptr(hist, cpu)->nr[op][i];
+			len += sysfs_emit_at(page, len, " %llu", sum);
+		}
+		len += sysfs_emit_at(page, len, "\n");
+	}
+out:
+	rcu_read_unlock();
+	return len;
+}
+
 struct blk_queue_stats *blk_alloc_queue_stats(void)
 {
 	struct blk_queue_stats *stats;
@@ -213,6 +385,7 @@ struct blk_queue_stats *blk_alloc_queue_stats(void)
 	INIT_LIST_HEAD(&stats->callbacks);
 	spin_lock_init(&stats->lock);
 	stats->accounting = 0;
+	stats->hist = NULL;
 
 	return stats;
 }
@@ -224,5 +397,6 @@ void blk_free_queue_stats(struct blk_queue_stats *stats)
 
 	WARN_ON(!list_empty(&stats->callbacks));
 
+	free_percpu(stats->hist);
 	kfree(stats);
 }
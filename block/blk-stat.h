@@ -74,6 +74,10 @@ void blk_stat_add(struct request *rq, u64 now);
 void blk_stat_enable_accounting(struct request_queue *q);
 void blk_stat_disable_accounting(struct request_queue *q);
 
+int blk_stat_enable_lat_hist(struct request_queue *q);
+void blk_stat_disable_lat_hist(struct request_queue *q);
+ssize_t blk_stat_show_lat_hist(struct request_queue *q, char *page);
+
 /**
  * blk_stat_alloc_callback() - Allocate a block statistics callback.
  * @timer_fn: Timer callback function.
@@ -501,6 +501,32 @@ static ssize_t queue_poll_store(struct gendisk *disk, const char *page,
 	return ret;
 }
 
+static ssize_t queue_lat_hist_show(struct gendisk *disk, char *page)
+{
+	return blk_stat_show_lat_hist(disk->queue, page);
+}
+
+static ssize_t queue_lat_hist_store(struct gendisk *disk, const char *page,
+				    size_t count)
+{
+	bool enable;
+	int err;
+
+	err = kstrtobool(page, &enable);
+	if (err)
+		return err;
+
+	if (!enable) {
+		blk_stat_disable_lat_hist(disk->queue);
+		return count;
+	}
+
+	err = blk_stat_enable_lat_hist(disk->queue);
+	if (err)
+		return err;
+	return count;
+}
+
 static ssize_t queue_io_timeout_show(struct gendisk *disk, char *page)
 {
 	return sysfs_emit(page, "%u\n",
@@ -630,6 +656,7 @@ QUEUE_LIM_RW_ENTRY(queue_wc, "write_cache");
 QUEUE_LIM_RO_ENTRY(queue_fua, "fua");
 QUEUE_LIM_RO_ENTRY(queue_dax, "dax");
 QUEUE_RW_ENTRY(queue_io_timeout, "io_timeout");
+QUEUE_RW_ENTRY(queue_lat_hist, "latency_hist");
 QUEUE_LIM_RO_ENTRY(queue_virt_boundary_mask, "virt_boundary_mask");
 QUEUE_LIM_RO_ENTRY(queue_dma_alignment, "dma_alignment");
 
@@ -775,6 +802,7 @@ static struct attribute *blk_mq_queue_attrs[] = {
 	 */
 	&queue_rq_affinity_entry.attr,
 	&queue_io_timeout_entry.attr,
+	&queue_lat_hist_entry.attr,
 
 	NULL,
 };
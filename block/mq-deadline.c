@@ -99,10 +99,33 @@ struct deadline_data {
 	int writes_starved;
 	int front_merges;
 	int prio_aging_expire;
+	int staged_insert;
 
 	spinlock_t lock;
+
+	/*
+	 * With staged_insert set, inserted requests are queued here under
+	 * insert_lock only and sorted in by the next dispatch or merge
+	 * attempt, which holds dd->lock anyway.
+	 */
+	spinlock_t insert_lock;
+	struct list_head insert_list;
+
+	/* number of times dd->lock was found held on the hot paths */
+	atomic_long_t lock_contended;
 };
 
+static void dd_lock(struct deadline_data *dd)
+	__acquires(&dd->lock)
+{
+	if (!spin_trylock(&dd->lock)) {
+		atomic_long_inc(&dd->lock_contended);
+		spin_lock(&dd->lock);
+	}
+}
+
+static void dd_insert_staged(struct deadline_data *dd, struct list_head *free);
+
 /* Maps an I/O priority class to a deadline scheduler priority. */
 static const enum dd_prio ioprio_class_to_prio[] = {
 	[IOPRIO_CLASS_NONE]	= DD_BE_PRIO,
@@ -455,8 +478,10 @@ static struct request *dd_dispatch_request(struct blk_mq_hw_ctx *hctx)
 	const unsigned long now = jiffies;
 	struct request *rq;
 	enum dd_prio prio;
+	LIST_HEAD(free);
 
-	spin_lock(&dd->lock);
+	dd_lock(dd);
+	dd_insert_staged(dd, &free);
 
 	if (!list_empty(&dd->dispatch)) {
 		rq = list_first_entry(&dd->dispatch, struct request, queuelist);
@@ -482,6 +507,8 @@ static struct request *dd_dispatch_request(struct blk_mq_hw_ctx *hctx)
 unlock:
 	spin_unlock(&dd->lock);
 
+	blk_mq_free_requests(&free);
+
 	return rq;
 }
 
@@ -502,6 +529,8 @@ static void dd_exit_sched(struct elevator_queue *e)
 	struct deadline_data *dd = e->elevator_data;
 	enum dd_prio prio;
 
+	WARN_ON_ONCE(!list_empty(&dd->insert_list));
+
 	for (prio = 0; prio <= DD_PRIO_MAX; prio++) {
 		struct dd_per_prio *per_prio = &dd->per_prio[prio];
 		const struct io_stats_per_prio *stats = &per_prio->stats;
@@ -554,6 +583,9 @@ static int dd_init_sched(struct request_queue *q, struct elevator_queue *eq)
 	dd->fifo_batch = fifo_batch;
 	dd->prio_aging_expire = prio_aging_expire;
 	spin_lock_init(&dd->lock);
+	spin_lock_init(&dd->insert_lock);
+	INIT_LIST_HEAD(&dd->insert_list);
+	atomic_long_set(&dd->lock_contended, 0);
 
 	/* We dispatch from request queue wide instead of hw queue */
 	blk_queue_flag_set(QUEUE_FLAG_SQ_SCHED, q);
@@ -605,12 +637,15 @@ static bool dd_bio_merge(struct request_queue *q, struct bio *bio,
 {
 	struct deadline_data *dd = q->elevator->elevator_data;
 	struct request *free = NULL;
+	LIST_HEAD(merged);
 	bool ret;
 
-	spin_lock(&dd->lock);
+	dd_lock(dd);
+	dd_insert_staged(dd, &merged);
 	ret = blk_mq_sched_try_merge(q, bio, nr_segs, &free);
 	spin_unlock(&dd->lock);
 
+	blk_mq_free_requests(&merged);
 	if (free)
 		blk_mq_free_request(free);
 
@@ -664,6 +699,32 @@ static void dd_insert_request(struct blk_mq_hw_ctx *hctx, struct request *rq,
 	}
 }
 
+/*
+ * Sort the requests queued on dd->insert_list into the scheduler data
+ * structures. Requests merged away are added to @free.
+ */
+static void dd_insert_staged(struct deadline_data *dd, struct list_head *free)
+{
+	LIST_HEAD(list);
+
+	lockdep_assert_held(&dd->lock);
+
+	if (list_empty_careful(&dd->insert_list))
+		return;
+
+	spin_lock(&dd->insert_lock);
+	list_splice_init(&dd->insert_list, &list);
+	spin_unlock(&dd->insert_lock);
+
+	while (!list_empty(&list)) {
+		struct request *rq;
+
+		rq = list_first_entry(&list, struct request, queuelist);
+		list_del_init(&rq->queuelist);
+		dd_insert_request(rq->mq_hctx, rq, 0, free);
+	}
+}
+
 /*
  * Called from blk_mq_insert_request() or blk_mq_dispatch_list().
  */
@@ -675,7 +736,14 @@ static void dd_insert_requests(struct blk_mq_hw_ctx *hctx,
 	struct deadline_data *dd = q->elevator->elevator_data;
 	LIST_HEAD(free);
 
-	spin_lock(&dd->lock);
+	if (dd->staged_insert && !(flags & BLK_MQ_INSERT_AT_HEAD)) {
+		spin_lock(&dd->insert_lock);
+		list_splice_tail_init(list, &dd->insert_list);
+		spin_unlock(&dd->insert_lock);
+		return;
+	}
+
+	dd_lock(dd);
 	while (!list_empty(list)) {
 		struct request *rq;
 
@@ -721,7 +789,8 @@ static bool dd_has_work(struct blk_mq_hw_ctx *hctx)
 	struct deadline_data *dd = hctx->queue->elevator->elevator_data;
 	enum dd_prio prio;
 
-	if (!list_empty_careful(&dd->dispatch))
+	if (!list_empty_careful(&dd->dispatch) ||
+	    !list_empty_careful(&dd->insert_list))
 		return true;
 
 	for (prio = 0; prio <= DD_PRIO_MAX; prio++)
@@ -748,6 +817,7 @@ SHOW_JIFFIES(deadline_prio_aging_expire_show, dd->prio_aging_expire);
 SHOW_INT(deadline_writes_starved_show, dd->writes_starved);
 SHOW_INT(deadline_front_merges_show, dd->front_merges);
 SHOW_INT(deadline_fifo_batch_show, dd->fifo_batch);
+SHOW_INT(deadline_staged_insert_show, dd->staged_insert);
 #undef SHOW_INT
 #undef SHOW_JIFFIES
 
@@ -777,6 +847,7 @@ STORE_JIFFIES(deadline_prio_aging_expire_store, &dd->prio_aging_expire, 0, INT_M
 STORE_INT(deadline_writes_starved_store, &dd->writes_starved, INT_MIN, INT_MAX);
 STORE_INT(deadline_front_merges_store, &dd->front_merges, 0, 1);
 STORE_INT(deadline_fifo_batch_store, &dd->fifo_batch, 0, INT_MAX);
+STORE_INT(deadline_staged_insert_store, &dd->staged_insert, 0, 1);
 #undef STORE_FUNCTION
 #undef STORE_INT
 #undef STORE_JIFFIES
@@ -791,6 +862,7 @@ static const struct elv_fs_entry deadline_attrs[] = {
 	DD_ATTR(front_merges),
 	DD_ATTR(fifo_batch),
 	DD_ATTR(prio_aging_expire),
+	DD_ATTR(staged_insert),
 	__ATTR_NULL
 };
 
@@ -875,6 +947,15 @@ static int deadline_starved_show(void *data, struct seq_file *m)
 	return 0;
 }
 
+static int deadline_lock_contended_show(void *data, struct seq_file *m)
+{
+	struct request_queue *q = data;
+	struct deadline_data *dd = q->elevator->elevator_data;
+
+	seq_printf(m, "%lu\n", atomic_long_read(&dd->lock_contended));
+	return 0;
+}
+
 static int dd_queued_show(void *data, struct seq_file *m)
 {
 	struct request_queue *q = data;
@@ -974,6 +1055,7 @@ static const struct blk_mq_debugfs_attr deadline_queue_debugfs_attrs[] = {
 	DEADLINE_NEXT_RQ_ATTR(write2),
 	{"batching", 0400, deadline_batching_show},
 	{"starved", 0400, deadline_starved_show},
+	{"lock_contended", 0400, deadline_lock_contended_show},
 	{"dispatch", 0400, .seq_ops = &deadline_dispatch_seq_ops},
 	{"owned_by_driver", 0400, dd_owned_by_driver_show},
 	{"queued", 0400, dd_queued_show},
@@ -182,12 +182,24 @@ static int pcrypt_aead_init_tfm(struct crypto_aead *tfm)
 	struct aead_instance *inst = aead_alg_instance(tfm);
 	struct pcrypt_instance_ctx *ictx = aead_instance_ctx(inst);
 	struct pcrypt_aead_ctx *ctx = crypto_aead_ctx(tfm);
+	const struct cpumask *node_mask = cpumask_of_node(numa_node_id());
 	struct crypto_aead *cipher;
-
-	cpu_index = (unsigned int)atomic_inc_return(&ictx->tfm_count) %
-		    cpumask_weight(cpu_online_mask);
-
-	ctx->cb_cpu = cpumask_nth(cpu_index, cpu_online_mask);
+	unsigned int nr_node_cpus;
+
+	cpu_index = (unsigned int)atomic_inc_return(&ictx->tfm_count);
+
+	/*
+	 * Prefer a callback CPU on the node that sets up the tfm, which is
+	 * usually the node that submits its requests, so that the serial
+	 * completion doesn't pull the request data across nodes.
+	 */
+	nr_node_cpus = cpumask_weight_and(node_mask, cpu_online_mask);
+	if (nr_node_cpus)
+		ctx->cb_cpu = cpumask_nth_and(cpu_index % nr_node_cpus,
+					      node_mask, cpu_online_mask);
+	else
+		ctx->cb_cpu = cpumask_nth(cpu_index % cpumask_weight(cpu_online_mask),
+					  cpu_online_mask);
 	cipher = crypto_spawn_aead(&ictx->spawn);
 
 	if (IS_ERR(cipher))
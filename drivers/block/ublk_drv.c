@@ -271,6 +271,8 @@ struct ublk_queue {
 	 * Key Invariants:
 	 * - At most one active_fcmd at any time (single reader)
 	 * - active_fcmd is always from fcmd_head list when non-NULL
+	 * - fetch commands are activated round-robin, so events are spread
+	 *   over all io_uring contexts serving the queue
 	 * - evts_fifo can be read locklessly by the single active reader
 	 * - All state transitions require evts_lock protection
 	 * - Multiple writers to evts_fifo require lock protection
@@ -1903,6 +1905,15 @@ static struct ublk_batch_fetch_cmd *__ublk_acquire_fcmd(
 	} else {
 		fcmd = list_first_entry_or_null(&ubq->fcmd_head,
 				struct ublk_batch_fetch_cmd, node);
+		/*
+		 * Rotate the chosen command to the tail, so that the next
+		 * batch goes to the fetch command of another server thread.
+		 * Auto buffer registration is done against the ring of the
+		 * fetch command, so each thread gets its requests' buffers
+		 * registered in its own ring.
+		 */
+		if (fcmd)
+			list_move_tail(&fcmd->node, &ubq->fcmd_head);
 		WRITE_ONCE(ubq->active_fcmd, fcmd);
 	}
 	return fcmd;
@@ -655,9 +655,22 @@ static void batch_from_pages(struct pfn_batch *batch, struct page **pages,
 {
 	struct page **end = pages + npages;
 
-	for (; pages != end; pages++)
-		if (!batch_add_pfn(batch, page_to_pfn(*pages)))
+	while (pages != end) {
+		unsigned long pfn = page_to_pfn(*pages);
+		u32 nr = 1;
+
+		/*
+		 * pin_user_pages() returns huge folios one struct page at a
+		 * time. Add each physically contiguous run in one go rather
+		 * than growing the batch entry page by page.
+		 */
+		while (pages + nr != end && page_to_pfn(pages[nr]) == pfn + nr)
+			nr++;
+
+		if (!batch_add_pfn_num(batch, pfn, nr, BATCH_CPU_MEMORY))
 			break;
+		pages += nr;
+	}
 }
 
 static int batch_from_folios(struct pfn_batch *batch, struct folio ***folios_p,
@@ -797,8 +797,14 @@ static struct entry *get_entry(struct entry_alloc *ea, unsigned int index)
 struct smq_policy {
 	struct dm_cache_policy policy;
 
-	/* protects everything */
+	/* protects everything, except for the hotspot state below */
 	spinlock_t lock;
+
+	/*
+	 * Protects the hotspot queue, table, allocator, hit bits and stats,
+	 * which are only updated on lookup misses.  Nests inside lock.
+	 */
+	spinlock_t hotspot_lock;
 	dm_cblock_t cache_size;
 	sector_t cache_block_size;
 
@@ -1373,14 +1379,12 @@ static void smq_destroy(struct dm_cache_policy *p)
 
 /*----------------------------------------------------------------*/
 
-static int __lookup(struct smq_policy *mq, dm_oblock_t oblock, dm_cblock_t *cblock,
-		    int data_dir, bool fast_copy,
-		    struct policy_work **work, bool *background_work)
+/*
+ * Looks the block up in the cache proper.  Must be called with mq->lock held.
+ */
+static int __lookup_hit(struct smq_policy *mq, dm_oblock_t oblock, dm_cblock_t *cblock)
 {
-	struct entry *e, *hs_e;
-	enum promote_result pr;
-
-	*background_work = false;
+	struct entry *e;
 
 	e = h_lookup(&mq->table, oblock);
 	if (e) {
@@ -1389,40 +1393,72 @@ static int __lookup(struct smq_policy *mq, dm_oblock_t oblock, dm_cblock_t *cblo
 		requeue(mq, e);
 		*cblock = infer_cblock(mq, e);
 		return 0;
+	}
 
-	} else {
-		stats_miss(&mq->cache_stats);
+	stats_miss(&mq->cache_stats);
+	return -ENOENT;
+}
+
+/*
+ * The hotspot queue only gets updated with misses, so it has its own lock
+ * and misses don't hold mq->lock while updating it.  Returns true if the
+ * block should be promoted.
+ */
+static bool __lookup_miss(struct smq_policy *mq, dm_oblock_t oblock,
+			  int data_dir, bool fast_copy)
+{
+	struct entry *hs_e;
+	enum promote_result pr;
 
+	spin_lock(&mq->hotspot_lock);
+	hs_e = update_hotspot_queue(mq, oblock);
+	pr = should_promote(mq, hs_e, data_dir, fast_copy);
+	spin_unlock(&mq->hotspot_lock);
+
+	return pr != PROMOTE_NOT;
+}
+
+static int __lookup(struct smq_policy *mq, dm_oblock_t oblock, dm_cblock_t *cblock,
+		    int data_dir, bool fast_copy,
+		    struct policy_work **work, bool *background_work)
+{
+	unsigned long flags;
+	int r;
+
+	*background_work = false;
+
+	spin_lock_irqsave(&mq->lock, flags);
+	r = __lookup_hit(mq, oblock, cblock);
+	spin_unlock_irqrestore(&mq->lock, flags);
+	if (!r)
+		return 0;
+
+	local_irq_save(flags);
+	if (__lookup_miss(mq, oblock, data_dir, fast_copy)) {
+		spin_lock(&mq->lock);
 		/*
-		 * The hotspot queue only gets updated with misses.
+		 * The block may have been promoted while we weren't holding
+		 * the lock.
 		 */
-		hs_e = update_hotspot_queue(mq, oblock);
-
-		pr = should_promote(mq, hs_e, data_dir, fast_copy);
-		if (pr != PROMOTE_NOT) {
+		if (!h_lookup(&mq->table, oblock)) {
 			queue_promotion(mq, oblock, work);
 			*background_work = true;
 		}
-
-		return -ENOENT;
+		spin_unlock(&mq->lock);
 	}
+	local_irq_restore(flags);
+
+	return -ENOENT;
 }
 
 static int smq_lookup(struct dm_cache_policy *p, dm_oblock_t oblock, dm_cblock_t *cblock,
 		      int data_dir, bool fast_copy,
 		      bool *background_work)
 {
-	int r;
-	unsigned long flags;
 	struct smq_policy *mq = to_smq_policy(p);
 
-	spin_lock_irqsave(&mq->lock, flags);
-	r = __lookup(mq, oblock, cblock,
-		     data_dir, fast_copy,
-		     NULL, background_work);
-	spin_unlock_irqrestore(&mq->lock, flags);
-
-	return r;
+	return __lookup(mq, oblock, cblock, data_dir, fast_copy,
+			NULL, background_work);
 }
 
 static int smq_lookup_with_work(struct dm_cache_policy *p,
@@ -1430,16 +1466,11 @@ static int smq_lookup_with_work(struct dm_cache_policy *p,
 				int data_dir, bool fast_copy,
 				struct policy_work **work)
 {
-	int r;
 	bool background_queued;
-	unsigned long flags;
 	struct smq_policy *mq = to_smq_policy(p);
 
-	spin_lock_irqsave(&mq->lock, flags);
-	r = __lookup(mq, oblock, cblock, data_dir, fast_copy, work, &background_queued);
-	spin_unlock_irqrestore(&mq->lock, flags);
-
-	return r;
+	return __lookup(mq, oblock, cblock, data_dir, fast_copy, work,
+			&background_queued);
 }
 
 static int smq_get_background_work(struct dm_cache_policy *p, bool idle,
@@ -1632,7 +1663,9 @@ static void smq_tick(struct dm_cache_policy *p, bool can_block)
 	spin_lock_irqsave(&mq->lock, flags);
 	mq->tick++;
 	update_sentinels(mq);
+	spin_lock(&mq->hotspot_lock);
 	end_hotspot_period(mq);
+	spin_unlock(&mq->hotspot_lock);
 	end_cache_period(mq);
 	spin_unlock_irqrestore(&mq->lock, flags);
 }
@@ -1788,6 +1821,7 @@ __smq_create(dm_cblock_t cache_size, sector_t origin_size, sector_t cache_block_
 
 	mq->tick = 0;
 	spin_lock_init(&mq->lock);
+	spin_lock_init(&mq->hotspot_lock);
 
 	q_init(&mq->hotspot, &mq->es, NR_HOTSPOT_LEVELS);
 	mq->hotspot.nr_top_levels = 8;
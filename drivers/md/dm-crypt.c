@@ -150,6 +150,7 @@ enum cipher_flags {
 	CRYPT_IV_LARGE_SECTORS,		/* Calculate IV from sector_size, not 512B sectors */
 	CRYPT_ENCRYPT_PREPROCESS,	/* Must preprocess data for encryption (elephant) */
 	CRYPT_KEY_MAC_SIZE_SET,		/* The integrity_key_size option was used */
+	CRYPT_MODE_SYNC,		/* Cipher never completes asynchronously */
 };
 
 /*
@@ -1551,6 +1552,8 @@ static blk_status_t crypt_convert(struct crypt_config *cc,
 			 struct convert_context *ctx, bool atomic, bool reset_pending)
 {
 	unsigned int sector_step = cc->sector_size >> SECTOR_SHIFT;
+	bool sync = test_bit(CRYPT_MODE_SYNC, &cc->cipher_flags);
+	unsigned int batch = 0;
 	int r;
 
 	/*
@@ -1569,7 +1572,12 @@ static blk_status_t crypt_convert(struct crypt_config *cc,
 			return BLK_STS_DEV_RESOURCE;
 		}
 
-		atomic_inc(&ctx->cc_pending);
+		/*
+		 * A synchronous cipher has always finished with the sector by
+		 * the time it returns, so there is no completion to account.
+		 */
+		if (!sync)
+			atomic_inc(&ctx->cc_pending);
 
 		if (crypt_integrity_aead(cc))
 			r = crypt_convert_block_aead(cc, ctx, ctx->r.req_aead, ctx->tag_offset);
@@ -1616,23 +1624,34 @@ static blk_status_t crypt_convert(struct crypt_config *cc,
 		 * The request was already processed (synchronously).
 		 */
 		case 0:
-			atomic_dec(&ctx->cc_pending);
+			if (!sync)
+				atomic_dec(&ctx->cc_pending);
 			ctx->cc_sector += sector_step;
 			ctx->tag_offset++;
-			if (!atomic)
+			/*
+			 * Reschedule at most once per page worth of data, so
+			 * small sectors on a fast cipher aren't dominated by
+			 * the per-sector overhead.
+			 */
+			batch += cc->sector_size;
+			if (!atomic && batch >= PAGE_SIZE) {
+				batch = 0;
 				cond_resched();
+			}
 			continue;
 		/*
 		 * There was a data integrity error.
 		 */
 		case -EBADMSG:
-			atomic_dec(&ctx->cc_pending);
+			if (!sync)
+				atomic_dec(&ctx->cc_pending);
 			return BLK_STS_PROTECTION;
 		/*
 		 * There was an error while processing the request.
 		 */
 		default:
-			atomic_dec(&ctx->cc_pending);
+			if (!sync)
+				atomic_dec(&ctx->cc_pending);
 			return BLK_STS_IOERR;
 		}
 	}
@@ -2354,6 +2373,9 @@ static int crypt_alloc_tfms_skcipher(struct crypt_config *cc, char *ciphermode)
 	 * algorithm implementation is used.  Help people debug performance
 	 * problems by logging the ->cra_driver_name.
 	 */
+	if (!(crypto_skcipher_alg(any_tfm(cc))->base.cra_flags & CRYPTO_ALG_ASYNC))
+		set_bit(CRYPT_MODE_SYNC, &cc->cipher_flags);
+
 	DMDEBUG_LIMIT("%s using implementation \"%s\"", ciphermode,
 	       crypto_skcipher_alg(any_tfm(cc))->base.cra_driver_name);
 	return 0;
@@ -2375,6 +2397,9 @@ static int crypt_alloc_tfms_aead(struct crypt_config *cc, char *ciphermode)
 		return err;
 	}
 
+	if (!(crypto_aead_alg(any_tfm_aead(cc))->base.cra_flags & CRYPTO_ALG_ASYNC))
+		set_bit(CRYPT_MODE_SYNC, &cc->cipher_flags);
+
 	DMDEBUG_LIMIT("%s using implementation \"%s\"", ciphermode,
 	       crypto_aead_alg(any_tfm_aead(cc))->base.cra_driver_name);
 	return 0;
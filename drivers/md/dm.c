@@ -2828,8 +2828,10 @@ static int dm_wait_for_completion(struct mapped_device *md, unsigned int task_st
 static void dm_wq_work(struct work_struct *work)
 {
 	struct mapped_device *md = container_of(work, struct mapped_device, work);
+	struct blk_plug plug;
 	struct bio *bio;
 
+	blk_start_plug(&plug);
 	while (!test_bit(DMF_BLOCK_IO_FOR_SUSPEND, &md->flags)) {
 		spin_lock_irq(&md->deferred_lock);
 		bio = bio_list_pop(&md->deferred);
@@ -2841,6 +2843,7 @@ static void dm_wq_work(struct work_struct *work)
 		submit_bio_noacct(bio);
 		cond_resched();
 	}
+	blk_finish_plug(&plug);
 }
 
 static void dm_queue_flush(struct mapped_device *md)
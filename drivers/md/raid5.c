@@ -430,7 +430,7 @@ static inline void remove_hash(struct stripe_head *sh)
 	pr_debug("remove_hash(), stripe %llu\n",
 		(unsigned long long)sh->sector);
 
-	hlist_del_init(&sh->hash);
+	hlist_del_init_rcu(&sh->hash);
 }
 
 static inline void insert_hash(struct r5conf *conf, struct stripe_head *sh)
@@ -440,7 +440,7 @@ static inline void insert_hash(struct r5conf *conf, struct stripe_head *sh)
 	pr_debug("insert_hash(), stripe %llu\n",
 		(unsigned long long)sh->sector);
 
-	hlist_add_head(&sh->hash, hp);
+	hlist_add_head_rcu(&sh->hash, hp);
 }
 
 /* find an idle stripe, make sure it is unhashed, and return it. */
@@ -632,6 +632,41 @@ static struct stripe_head *__find_stripe(struct r5conf *conf, sector_t sector,
 	return NULL;
 }
 
+/*
+ * Lockless variant of find_get_stripe() for the common case of a stripe that
+ * is already active. Stripe heads are SLAB_TYPESAFE_BY_RCU, so a stripe found
+ * under RCU may have been recycled for another sector by the time we get our
+ * reference; recheck its identity once the reference is held. Returns NULL if
+ * the stripe is not in the cache or is idle, in which case the caller has to
+ * fall back to the locked lookup.
+ */
+static struct stripe_head *find_get_stripe_lockless(struct r5conf *conf,
+		sector_t sector, short generation)
+{
+	struct stripe_head *sh;
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(sh, stripe_hash(conf, sector), hash) {
+		if (READ_ONCE(sh->sector) != sector ||
+		    READ_ONCE(sh->generation) != generation)
+			continue;
+		if (!atomic_inc_not_zero(&sh->count))
+			break;
+		rcu_read_unlock();
+
+		if (READ_ONCE(sh->sector) == sector &&
+		    READ_ONCE(sh->generation) == generation &&
+		    !hlist_unhashed_lockless(&sh->hash))
+			return sh;
+
+		raid5_release_stripe(sh);
+		return NULL;
+	}
+	rcu_read_unlock();
+
+	return NULL;
+}
+
 static struct stripe_head *find_get_stripe(struct r5conf *conf,
 		sector_t sector, short generation, int hash)
 {
@@ -814,6 +849,18 @@ struct stripe_head *raid5_get_active_stripe(struct r5conf *conf,
 
 	pr_debug("get_stripe, sector %llu\n", (unsigned long long)sector);
 
+	/*
+	 * Writers piling onto a stripe that is already being handled don't
+	 * need the hash lock. raid5_quiesce() can't complete while such a
+	 * stripe is active, so adding to it races benignly with a quiesce.
+	 */
+	if ((flags & R5_GAS_NOQUIESCE) || !smp_load_acquire(&conf->quiesce)) {
+		sh = find_get_stripe_lockless(conf, sector,
+				READ_ONCE(conf->generation) - previous);
+		if (sh)
+			return sh;
+	}
+
 	spin_lock_irq(conf->hash_locks + hash);
 
 	for (;;) {
@@ -845,6 +892,8 @@ struct stripe_head *raid5_get_active_stripe(struct r5conf *conf,
 			if (sh) {
 				r5c_check_stripe_cache_usage(conf);
 				init_stripe(sh, sector, previous);
+				/* pairs with find_get_stripe_lockless() */
+				smp_mb__before_atomic();
 				atomic_inc(&sh->count);
 				break;
 			}
@@ -2419,7 +2468,7 @@ static int grow_stripes(struct r5conf *conf, int num)
 	conf->active_name = 0;
 	sc = kmem_cache_create(conf->cache_name[conf->active_name],
 			       struct_size_t(struct stripe_head, dev, devs),
-			       0, 0, NULL);
+			       0, SLAB_TYPESAFE_BY_RCU, NULL);
 	if (!sc)
 		return 1;
 	conf->slab_cache = sc;
@@ -2543,7 +2592,7 @@ static int resize_stripes(struct r5conf *conf, int newsize)
 	/* Step 1 */
 	sc = kmem_cache_create(conf->cache_name[1-conf->active_name],
 			       struct_size_t(struct stripe_head, dev, newsize),
-			       0, 0, NULL);
+			       0, SLAB_TYPESAFE_BY_RCU, NULL);
 	if (!sc)
 		return -ENOMEM;
 
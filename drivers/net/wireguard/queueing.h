@@ -116,12 +116,21 @@ static inline int wg_cpumask_choose_online(int *stored_cpu, unsigned int id)
  * unlocked, so it could return the same CPU twice. Adding locking or using
  * atomic sequence numbers is slower though, and the consequences of racing are
  * harmless, so live with it.
+ *
+ * CPUs on the local node are preferred, so that work on packets that were just
+ * received or queued here doesn't drag them across the interconnect.
  */
 static inline int wg_cpumask_next_online(int *last_cpu)
 {
-	int cpu = cpumask_next(READ_ONCE(*last_cpu), cpu_online_mask);
+	const struct cpumask *node_mask = cpumask_of_node(numa_node_id());
+	int cpu = cpumask_next_and(READ_ONCE(*last_cpu), node_mask, cpu_online_mask);
 	if (cpu >= nr_cpu_ids)
-		cpu = cpumask_first(cpu_online_mask);
+		cpu = cpumask_first_and(node_mask, cpu_online_mask);
+	if (cpu >= nr_cpu_ids) {
+		cpu = cpumask_next(READ_ONCE(*last_cpu), cpu_online_mask);
+		if (cpu >= nr_cpu_ids)
+			cpu = cpumask_first(cpu_online_mask);
+	}
 	WRITE_ONCE(*last_cpu, cpu);
 	return cpu;
 }
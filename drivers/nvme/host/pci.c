@@ -82,6 +82,21 @@ struct quirk_entry {
 static int use_threaded_interrupts;
 module_param(use_threaded_interrupts, int, 0444);
 
+static bool hybrid_poll;
+module_param(hybrid_poll, bool, 0444);
+MODULE_PARM_DESC(hybrid_poll,
+	"also reap completions of interrupt driven I/O queues on submission "
+	"while the queue is busy, see the hybrid_poll_depth sysfs attribute");
+
+#define NVME_HYBRID_POLL_DEPTH	32
+
+/*
+ * Hybrid queues take cq_poll_lock from their interrupt handler, the other
+ * queues only from process or softirq context without disabling interrupts.
+ */
+static struct lock_class_key nvme_cq_poll_lock_key;
+static struct lock_class_key nvme_hybrid_cq_poll_lock_key;
+
 static bool use_cmb_sqes = true;
 module_param(use_cmb_sqes, bool, 0444);
 MODULE_PARM_DESC(use_cmb_sqes, "use controller's memory buffer for I/O SQes");
@@ -334,6 +349,7 @@ struct nvme_dev {
 	unsigned int nr_allocated_queues;
 	unsigned int nr_write_queues;
 	unsigned int nr_poll_queues;
+	unsigned int hybrid_poll_depth;
 	struct nvme_descriptor_pools descriptor_pools[];
 };
 
@@ -367,9 +383,11 @@ struct nvme_queue {
 	struct nvme_descriptor_pools descriptor_pools;
 	spinlock_t sq_lock;
 	void *sq_cmds;
-	 /* only used for poll queues: */
+	 /* only used for poll and hybrid queues: */
 	spinlock_t cq_poll_lock ____cacheline_aligned_in_smp;
 	struct nvme_completion *cqes;
+	u64 irq_cqes;
+	u64 polled_cqes;
 	dma_addr_t sq_dma_addr;
 	dma_addr_t cq_dma_addr;
 	u32 __iomem *q_db;
@@ -386,6 +404,7 @@ struct nvme_queue {
 #define NVMEQ_SQ_CMB		1
 #define NVMEQ_DELETE_ERROR	2
 #define NVMEQ_POLLED		3
+#define NVMEQ_HYBRID		4
 	__le32 *dbbuf_sq_db;
 	__le32 *dbbuf_cq_db;
 	__le32 *dbbuf_sq_ei;
@@ -937,6 +956,8 @@ static void nvme_unmap_data(struct request *req)
 				offsetof(union nvme_data_ptr, sgl.addr));
 		dma_unmap_page(dma_dev, le64_to_cpu(iod->cmd.common.dptr.prp1),
 				iod->total_len, rq_dma_dir(req));
+		if (iod->nr_descriptors)
+			nvme_free_descriptors(req);
 		return;
 	}
 
@@ -1174,6 +1195,38 @@ static blk_status_t nvme_pci_setup_data_sgl(struct request *req,
 	return iter->status;
 }
 
+/*
+ * Fill a single PRP list for the physically contiguous remainder of a single
+ * segment request, e.g. I/O into a registered buffer backed by huge pages.
+ * As the segment is contiguous in IOVA space, there is no need to go through
+ * the DMA iterator to find the address of each controller page.
+ */
+static blk_status_t nvme_pci_setup_prp_list_contig(struct request *req,
+		dma_addr_t dma_addr, unsigned int length)
+{
+	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
+	struct nvme_queue *nvmeq = req->mq_hctx->driver_data;
+	unsigned int i, nr_prps = DIV_ROUND_UP(length, NVME_CTRL_PAGE_SIZE);
+	dma_addr_t prp_dma;
+	__le64 *prp_list;
+
+	if (nr_prps <= NVME_SMALL_POOL_SIZE / sizeof(__le64))
+		iod->flags |= IOD_SMALL_DESCRIPTOR;
+
+	prp_list = dma_pool_alloc(nvme_dma_pool(nvmeq, iod), GFP_ATOMIC,
+			&prp_dma);
+	if (!prp_list) {
+		nvme_unmap_data(req);
+		return BLK_STS_RESOURCE;
+	}
+	iod->descriptors[iod->nr_descriptors++] = prp_list;
+
+	for (i = 0; i < nr_prps; i++)
+		prp_list[i] = cpu_to_le64(dma_addr + i * NVME_CTRL_PAGE_SIZE);
+	iod->cmd.common.dptr.prp2 = cpu_to_le64(prp_dma);
+	return BLK_STS_OK;
+}
+
 static blk_status_t nvme_pci_setup_data_simple(struct request *req,
 		enum nvme_use_sgl use_sgl)
 {
@@ -1184,7 +1237,13 @@ static blk_status_t nvme_pci_setup_data_simple(struct request *req,
 	bool prp_possible = prp1_offset + bv.bv_len <= NVME_CTRL_PAGE_SIZE * 2;
 	dma_addr_t dma_addr;
 
-	if (!use_sgl && !prp_possible)
+	/*
+	 * Without SGLs, a segment that needs a PRP list is still handled here
+	 * as long as the list fits into a single descriptor.
+	 */
+	if (!use_sgl && !prp_possible &&
+	    DIV_ROUND_UP(prp1_offset + bv.bv_len, NVME_CTRL_PAGE_SIZE) - 1 >
+	    NVME_CTRL_PAGE_SIZE / sizeof(__le64))
 		return BLK_STS_AGAIN;
 	if (is_pci_p2pdma_page(bv.bv_page))
 		return BLK_STS_AGAIN;
@@ -1195,7 +1254,7 @@ static blk_status_t nvme_pci_setup_data_simple(struct request *req,
 	iod->total_len = bv.bv_len;
 	iod->flags |= IOD_SINGLE_SEGMENT;
 
-	if (use_sgl == SGL_FORCED || !prp_possible) {
+	if (use_sgl == SGL_FORCED || (use_sgl && !prp_possible)) {
 		iod->cmd.common.flags = NVME_CMD_SGL_METABUF;
 		iod->cmd.common.dptr.sgl.addr = cpu_to_le64(dma_addr);
 		iod->cmd.common.dptr.sgl.length = cpu_to_le32(bv.bv_len);
@@ -1205,6 +1264,10 @@ static blk_status_t nvme_pci_setup_data_simple(struct request *req,
 
 		iod->cmd.common.dptr.prp1 = cpu_to_le64(dma_addr);
 		iod->cmd.common.dptr.prp2 = 0;
+		if (!prp_possible)
+			return nvme_pci_setup_prp_list_contig(req,
+					dma_addr + first_prp_len,
+					bv.bv_len - first_prp_len);
 		if (bv.bv_len > first_prp_len)
 			iod->cmd.common.dptr.prp2 =
 				cpu_to_le64(dma_addr + first_prp_len);
@@ -1402,6 +1465,21 @@ static blk_status_t nvme_prep_rq(struct request *req)
 	return ret;
 }
 
+static void nvme_hybrid_poll(struct nvme_queue *nvmeq);
+
+/* Called with sq_lock held, the CQ head is only sampled. */
+static inline bool nvme_hybrid_busy(struct nvme_queue *nvmeq)
+{
+	u32 outstanding;
+
+	if (!test_bit(NVMEQ_HYBRID, &nvmeq->flags))
+		return false;
+
+	outstanding = (nvmeq->sq_tail + nvmeq->q_depth -
+		       data_race(nvmeq->cq_head)) % nvmeq->q_depth;
+	return outstanding >= READ_ONCE(nvmeq->dev->hybrid_poll_depth);
+}
+
 static blk_status_t nvme_queue_rq(struct blk_mq_hw_ctx *hctx,
 			 const struct blk_mq_queue_data *bd)
 {
@@ -1410,6 +1488,7 @@ static blk_status_t nvme_queue_rq(struct blk_mq_hw_ctx *hctx,
 	struct request *req = bd->rq;
 	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
 	blk_status_t ret;
+	bool busy;
 
 	/*
 	 * We should not need to do this, but we're still using this to
@@ -1427,13 +1506,18 @@ static blk_status_t nvme_queue_rq(struct blk_mq_hw_ctx *hctx,
 	spin_lock(&nvmeq->sq_lock);
 	nvme_sq_copy_cmd(nvmeq, &iod->cmd);
 	nvme_write_sq_db(nvmeq, bd->last);
+	busy = bd->last && nvme_hybrid_busy(nvmeq);
 	spin_unlock(&nvmeq->sq_lock);
+
+	if (busy)
+		nvme_hybrid_poll(nvmeq);
 	return BLK_STS_OK;
 }
 
 static void nvme_submit_cmds(struct nvme_queue *nvmeq, struct rq_list *rqlist)
 {
 	struct request *req;
+	bool busy;
 
 	if (rq_list_empty(rqlist))
 		return;
@@ -1445,7 +1529,11 @@ static void nvme_submit_cmds(struct nvme_queue *nvmeq, struct rq_list *rqlist)
 		nvme_sq_copy_cmd(nvmeq, &iod->cmd);
 	}
 	nvme_write_sq_db(nvmeq, true);
+	busy = nvme_hybrid_busy(nvmeq);
 	spin_unlock(&nvmeq->sq_lock);
+
+	if (busy)
+		nvme_hybrid_poll(nvmeq);
 }
 
 static bool nvme_prep_rq_batch(struct nvme_queue *nvmeq, struct request *req)
@@ -1575,13 +1663,13 @@ static inline void nvme_update_cq_head(struct nvme_queue *nvmeq)
 	}
 }
 
-static inline bool nvme_poll_cq(struct nvme_queue *nvmeq,
-			        struct io_comp_batch *iob)
+static inline unsigned int nvme_poll_cq(struct nvme_queue *nvmeq,
+					struct io_comp_batch *iob)
 {
-	bool found = false;
+	unsigned int found = 0;
 
 	while (nvme_cqe_pending(nvmeq)) {
-		found = true;
+		found++;
 		/*
 		 * load-load control dependency between phase and the rest of
 		 * the cqe requires a full read memory barrier
@@ -1600,8 +1688,26 @@ static irqreturn_t nvme_irq(int irq, void *data)
 {
 	struct nvme_queue *nvmeq = data;
 	DEFINE_IO_COMP_BATCH(iob);
+	unsigned int found;
+
+	if (test_bit(NVMEQ_HYBRID, &nvmeq->flags)) {
+		spin_lock(&nvmeq->cq_poll_lock);
+		found = nvme_poll_cq(nvmeq, &iob);
+		nvmeq->irq_cqes += found;
+		spin_unlock(&nvmeq->cq_poll_lock);
+
+		if (!rq_list_empty(&iob.req_list))
+			nvme_pci_complete_batch(&iob);
+		/*
+		 * The submission side may have reaped the completion that
+		 * raised this interrupt, don't let that count as spurious.
+		 */
+		return IRQ_HANDLED;
+	}
 
-	if (nvme_poll_cq(nvmeq, &iob)) {
+	found = nvme_poll_cq(nvmeq, &iob);
+	if (found) {
+		nvmeq->irq_cqes += found;
 		if (!rq_list_empty(&iob.req_list))
 			nvme_pci_complete_batch(&iob);
 		return IRQ_HANDLED;
@@ -1609,6 +1715,26 @@ static irqreturn_t nvme_irq(int irq, void *data)
 	return IRQ_NONE;
 }
 
+/*
+ * Hybrid queues are interrupt driven, but while many commands are outstanding
+ * the submitter also reaps completions, so that the interrupt mostly needs to
+ * fire once the queue goes idle.
+ */
+static void nvme_hybrid_poll(struct nvme_queue *nvmeq)
+{
+	DEFINE_IO_COMP_BATCH(iob);
+	unsigned long flags;
+
+	if (!nvme_cqe_pending(nvmeq) ||
+	    !spin_trylock_irqsave(&nvmeq->cq_poll_lock, flags))
+		return;
+	nvmeq->polled_cqes += nvme_poll_cq(nvmeq, &iob);
+	spin_unlock_irqrestore(&nvmeq->cq_poll_lock, flags);
+
+	if (!rq_list_empty(&iob.req_list))
+		nvme_pci_complete_batch(&iob);
+}
+
 static irqreturn_t nvme_irq_check(int irq, void *data)
 {
 	struct nvme_queue *nvmeq = data;
@@ -1631,9 +1757,9 @@ static void nvme_poll_irqdisable(struct nvme_queue *nvmeq)
 
 	irq = pci_irq_vector(pdev, nvmeq->cq_vector);
 	disable_irq(irq);
-	spin_lock(&nvmeq->cq_poll_lock);
+	spin_lock_irq(&nvmeq->cq_poll_lock);
 	nvme_poll_cq(nvmeq, NULL);
-	spin_unlock(&nvmeq->cq_poll_lock);
+	spin_unlock_irq(&nvmeq->cq_poll_lock);
 	enable_irq(irq);
 }
 
@@ -2043,9 +2169,10 @@ static void nvme_reap_pending_cqes(struct nvme_dev *dev)
 	int i;
 
 	for (i = dev->ctrl.queue_count - 1; i > 0; i--) {
-		spin_lock(&dev->queues[i].cq_poll_lock);
+		/* hybrid queues take the lock in their interrupt handler */
+		spin_lock_irq(&dev->queues[i].cq_poll_lock);
 		nvme_poll_cq(&dev->queues[i], NULL);
-		spin_unlock(&dev->queues[i].cq_poll_lock);
+		spin_unlock_irq(&dev->queues[i].cq_poll_lock);
 	}
 }
 
@@ -2203,6 +2330,16 @@ static int nvme_create_queue(struct nvme_queue *nvmeq, int qid, bool polled)
 	else
 		set_bit(NVMEQ_POLLED, &nvmeq->flags);
 
+	if (!polled && hybrid_poll) {
+		set_bit(NVMEQ_HYBRID, &nvmeq->flags);
+		lockdep_set_class(&nvmeq->cq_poll_lock,
+				  &nvme_hybrid_cq_poll_lock_key);
+	} else {
+		clear_bit(NVMEQ_HYBRID, &nvmeq->flags);
+		lockdep_set_class(&nvmeq->cq_poll_lock,
+				  &nvme_cq_poll_lock_key);
+	}
+
 	result = adapter_alloc_cq(dev, qid, nvmeq, vector);
 	if (result)
 		return result;
@@ -2774,6 +2911,44 @@ static ssize_t hmb_store(struct device *dev, struct device_attribute *attr,
 }
 static DEVICE_ATTR_RW(hmb);
 
+static ssize_t hybrid_poll_depth_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct nvme_dev *ndev = to_nvme_dev(dev_get_drvdata(dev));
+
+	return sysfs_emit(buf, "%u\n", READ_ONCE(ndev->hybrid_poll_depth));
+}
+
+static ssize_t hybrid_poll_depth_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct nvme_dev *ndev = to_nvme_dev(dev_get_drvdata(dev));
+	unsigned int depth;
+
+	if (kstrtouint(buf, 0, &depth) < 0 || !depth)
+		return -EINVAL;
+
+	WRITE_ONCE(ndev->hybrid_poll_depth, depth);
+	return count;
+}
+static DEVICE_ATTR_RW(hybrid_poll_depth);
+
+static ssize_t hybrid_poll_stats_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct nvme_dev *ndev = to_nvme_dev(dev_get_drvdata(dev));
+	u64 polled = 0, irq = 0;
+	unsigned int i;
+
+	for (i = 1; i < ndev->online_queues; i++) {
+		polled += data_race(ndev->queues[i].polled_cqes);
+		irq += data_race(ndev->queues[i].irq_cqes);
+	}
+
+	return sysfs_emit(buf, "%llu %llu\n", polled, irq);
+}
+static DEVICE_ATTR_RO(hybrid_poll_stats);
+
 static umode_t nvme_pci_attrs_are_visible(struct kobject *kobj,
 		struct attribute *a, int n)
 {
@@ -2789,6 +2964,9 @@ static umode_t nvme_pci_attrs_are_visible(struct kobject *kobj,
 	}
 	if (a == &dev_attr_hmb.attr && !ctrl->hmpre)
 		return 0;
+	if ((a == &dev_attr_hybrid_poll_depth.attr ||
+	     a == &dev_attr_hybrid_poll_stats.attr) && !hybrid_poll)
+		return 0;
 
 	return a->mode;
 }
@@ -2798,6 +2976,8 @@ static struct attribute *nvme_pci_attrs[] = {
 	&dev_attr_cmbloc.attr,
 	&dev_attr_cmbsz.attr,
 	&dev_attr_hmb.attr,
+	&dev_attr_hybrid_poll_depth.attr,
+	&dev_attr_hybrid_poll_stats.attr,
 	NULL,
 };
 
@@ -3653,6 +3833,7 @@ static struct nvme_dev *nvme_pci_alloc_dev(struct pci_dev *pdev,
 
 	dev->nr_write_queues = write_queues;
 	dev->nr_poll_queues = poll_queues;
+	dev->hybrid_poll_depth = NVME_HYBRID_POLL_DEPTH;
 	dev->nr_allocated_queues = nvme_max_io_queues(dev) + 1;
 	dev->queues = kcalloc_node(dev->nr_allocated_queues,
 			sizeof(struct nvme_queue), GFP_KERNEL, node);
@@ -40,6 +40,11 @@ module_param(experimental_zcopytx, int, 0444);
 MODULE_PARM_DESC(experimental_zcopytx, "Enable Zero Copy TX;"
 		                       " 1 -Enable; 0 - Disable");
 
+static unsigned int rx_used_batch = 64;
+module_param(rx_used_batch, uint, 0644);
+MODULE_PARM_DESC(rx_used_batch, "RX buffers (up to 256) to complete before updating"
+				" the used ring; 0 - update per packet");
+
 /* Max number of bytes transferred before requeueing the job.
  * Using this limit prevents one virtqueue from starving others. */
 #define VHOST_NET_WEIGHT 0x80000
@@ -103,6 +108,8 @@ struct vhost_net_ubuf_ref {
 };
 
 #define VHOST_NET_BATCH 64
+/* Largest rx_used_batch, the RX heads array has room for this many more */
+#define VHOST_NET_RX_USED_BATCH_MAX 256
 struct vhost_net_buf {
 	void **queue;
 	int tail;
@@ -1159,6 +1166,8 @@ static void handle_rx(struct vhost_net *net)
 	__virtio16 num_buffers;
 	int recv_pkts = 0;
 	unsigned int ndesc;
+	unsigned int used_batch = min_t(unsigned int, READ_ONCE(rx_used_batch),
+					VHOST_NET_RX_USED_BATCH_MAX);
 
 	mutex_lock_nested(&vq->mutex, VHOST_NET_VQ_RX);
 	sock = vhost_vq_get_backend(vq);
@@ -1266,7 +1275,7 @@ static void handle_rx(struct vhost_net *net)
 		}
 		nvq->done_idx += headcount;
 		count += in_order ? 1 : headcount;
-		if (nvq->done_idx > VHOST_NET_BATCH) {
+		if (nvq->done_idx > used_batch) {
 			vhost_net_signal_used(nvq, count);
 			count = 0;
 		}
@@ -1370,7 +1379,8 @@ static int vhost_net_open(struct inode *inode, struct file *f)
 		vhost_net_buf_init(&n->vqs[i].rxq);
 	}
 	vhost_dev_init(dev, vqs, VHOST_NET_VQ_MAX,
-		       UIO_MAXIOV + VHOST_NET_BATCH,
+		       UIO_MAXIOV + max(VHOST_NET_BATCH,
+					VHOST_NET_RX_USED_BATCH_MAX),
 		       VHOST_NET_PKT_WEIGHT, VHOST_NET_WEIGHT, true,
 		       NULL);
 
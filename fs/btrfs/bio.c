@@ -299,6 +299,126 @@ static struct btrfs_failed_bio *repair_one_sector(struct btrfs_bio *failed_bbio,
 	return fbio;
 }
 
+/*
+ * Large data read bios have their checksums verified in parallel, split into
+ * chunks of at least BTRFS_CSUM_VERIFY_CHUNK bytes which are handed to the
+ * unbound csum verification workqueue.  The end I/O worker verifies the first
+ * chunk itself and then waits for the rest.
+ */
+#define BTRFS_CSUM_VERIFY_CHUNK		SZ_256K
+#define BTRFS_CSUM_VERIFY_MAX_CHUNKS	16
+
+struct btrfs_csum_verify {
+	struct btrfs_bio *bbio;
+	struct btrfs_device *dev;
+	/* One bit per fs block that failed verification. */
+	unsigned long *bad;
+	atomic_t pending;
+	struct completion done;
+};
+
+struct btrfs_csum_verify_chunk {
+	struct work_struct work;
+	struct btrfs_csum_verify *verify;
+	struct bvec_iter iter;
+	/* Offset of the chunk into the bio, in bytes. */
+	u32 offset;
+};
+
+static void verify_csum_chunk(struct btrfs_csum_verify_chunk *chunk)
+{
+	struct btrfs_csum_verify *verify = chunk->verify;
+	struct btrfs_bio *bbio = verify->bbio;
+	struct btrfs_fs_info *fs_info = bbio->inode->root->fs_info;
+	const u32 sectorsize = fs_info->sectorsize;
+	const u32 step = min(sectorsize, PAGE_SIZE);
+	const u32 nr_steps = sectorsize / step;
+	phys_addr_t paddrs[BTRFS_MAX_BLOCKSIZE / PAGE_SIZE];
+	phys_addr_t paddr;
+	u32 offset = chunk->offset;
+
+	btrfs_bio_for_each_block(paddr, &bbio->bio, &chunk->iter, step) {
+		paddrs[(offset / step) % nr_steps] = paddr;
+		offset += step;
+
+		if (IS_ALIGNED(offset, sectorsize) &&
+		    !btrfs_data_csum_ok(bbio, verify->dev, offset - sectorsize, paddrs))
+			set_bit((offset - sectorsize) >> fs_info->sectorsize_bits,
+				verify->bad);
+	}
+
+	if (atomic_dec_and_test(&verify->pending))
+		complete(&verify->done);
+}
+
+static void verify_csum_chunk_work(struct work_struct *work)
+{
+	verify_csum_chunk(container_of(work, struct btrfs_csum_verify_chunk, work));
+}
+
+/*
+ * Verify the checksums of a large data read bio in parallel.
+ *
+ * Return a bitmap of the fs blocks that failed verification, to be released
+ * with bitmap_free() by the caller, or NULL if the bio was not verified and the
+ * caller has to do it inline.
+ */
+static unsigned long *btrfs_verify_csums_parallel(struct btrfs_bio *bbio,
+						  struct btrfs_device *dev)
+{
+	struct btrfs_fs_info *fs_info = bbio->inode->root->fs_info;
+	const u32 size = bbio->saved_iter.bi_size;
+	struct btrfs_csum_verify_chunk *chunks;
+	struct btrfs_csum_verify verify;
+	u32 chunk_size = BTRFS_CSUM_VERIFY_CHUNK;
+	unsigned int nr_chunks;
+
+	if (!bbio->csum || size < 2 * BTRFS_CSUM_VERIFY_CHUNK)
+		return NULL;
+
+	nr_chunks = DIV_ROUND_UP(size, chunk_size);
+	if (nr_chunks > BTRFS_CSUM_VERIFY_MAX_CHUNKS) {
+		chunk_size = round_up(DIV_ROUND_UP(size, BTRFS_CSUM_VERIFY_MAX_CHUNKS),
+				      fs_info->sectorsize);
+		nr_chunks = DIV_ROUND_UP(size, chunk_size);
+	}
+
+	verify.bad = bitmap_zalloc(size >> fs_info->sectorsize_bits, GFP_NOFS);
+	chunks = kmalloc_array(nr_chunks, sizeof(*chunks), GFP_NOFS);
+	if (!verify.bad || !chunks) {
+		bitmap_free(verify.bad);
+		kfree(chunks);
+		atomic64_inc(&fs_info->csum_verify_stats.fallbacks);
+		return NULL;
+	}
+	verify.bbio = bbio;
+	verify.dev = dev;
+	atomic_set(&verify.pending, nr_chunks);
+	init_completion(&verify.done);
+
+	for (unsigned int i = 0; i < nr_chunks; i++) {
+		struct btrfs_csum_verify_chunk *chunk = &chunks[i];
+
+		chunk->verify = &verify;
+		chunk->offset = i * chunk_size;
+		chunk->iter = bbio->saved_iter;
+		bio_advance_iter(&bbio->bio, &chunk->iter, chunk->offset);
+		chunk->iter.bi_size = min(chunk_size, size - chunk->offset);
+		if (i == 0)
+			continue;
+		INIT_WORK(&chunk->work, verify_csum_chunk_work);
+		queue_work(fs_info->endio_csum_workers, &chunk->work);
+	}
+	verify_csum_chunk(&chunks[0]);
+	wait_for_completion(&verify.done);
+	kfree(chunks);
+
+	atomic64_inc(&fs_info->csum_verify_stats.bios);
+	atomic64_add(nr_chunks, &fs_info->csum_verify_stats.chunks);
+	atomic64_add(size, &fs_info->csum_verify_stats.bytes);
+	return verify.bad;
+}
+
 static void btrfs_check_read_bio(struct btrfs_bio *bbio, struct btrfs_device *dev)
 {
 	struct btrfs_inode *inode = bbio->inode;
@@ -311,6 +431,7 @@ static void btrfs_check_read_bio(struct btrfs_bio *bbio, struct btrfs_device *de
 	struct btrfs_failed_bio *fbio = NULL;
 	phys_addr_t paddrs[BTRFS_MAX_BLOCKSIZE / PAGE_SIZE];
 	phys_addr_t paddr;
+	unsigned long *bad = NULL;
 	u32 offset = 0;
 
 	/* Read-repair requires the inode field to be set by the submitter. */
@@ -328,17 +449,28 @@ static void btrfs_check_read_bio(struct btrfs_bio *bbio, struct btrfs_device *de
 	/* Clear the I/O error. A failed repair will reset it. */
 	bbio->bio.bi_status = BLK_STS_OK;
 
+	if (!status)
+		bad = btrfs_verify_csums_parallel(bbio, dev);
+
 	btrfs_bio_for_each_block(paddr, &bbio->bio, iter, step) {
 		paddrs[(offset / step) % nr_steps] = paddr;
 		offset += step;
 
 		if (IS_ALIGNED(offset, sectorsize)) {
-			if (status ||
-			    !btrfs_data_csum_ok(bbio, dev, offset - sectorsize, paddrs))
-				fbio = repair_one_sector(bbio, offset - sectorsize,
-							 paddrs, fbio);
+			const u32 bio_offset = offset - sectorsize;
+			bool ok;
+
+			if (status)
+				ok = false;
+			else if (bad)
+				ok = !test_bit(bio_offset >> fs_info->sectorsize_bits, bad);
+			else
+				ok = btrfs_data_csum_ok(bbio, dev, bio_offset, paddrs);
+			if (!ok)
+				fbio = repair_one_sector(bbio, bio_offset, paddrs, fbio);
 		}
 	}
+	bitmap_free(bad);
 	if (bbio->csum != bbio->csum_inline)
 		kvfree(bbio->csum);
 
@@ -336,6 +336,13 @@ static struct btrfs_delayed_ref_node* tree_insert(struct rb_root_cached *root,
 	return rb_entry_safe(exist, struct btrfs_delayed_ref_node, ref_node);
 }
 
+/*
+ * Mark set in the head_refs xarray for heads that are not being processed, so
+ * that selecting the next head to run does not have to walk over all the heads
+ * other tasks are currently running.
+ */
+#define BTRFS_DELAYED_REF_HEAD_READY	XA_MARK_0
+
 static struct btrfs_delayed_ref_head *find_first_ref_head(
 		struct btrfs_delayed_ref_root *dr)
 {
@@ -477,21 +484,15 @@ struct btrfs_delayed_ref_head *btrfs_select_ref_head(
 		struct btrfs_delayed_ref_root *delayed_refs)
 {
 	struct btrfs_delayed_ref_head *head;
-	unsigned long start_index;
-	unsigned long found_index;
-	bool found_head = false;
+	unsigned long index;
 	bool locked;
 
 	spin_lock(&delayed_refs->lock);
 again:
-	start_index = (delayed_refs->run_delayed_start >> fs_info->sectorsize_bits);
-	xa_for_each_start(&delayed_refs->head_refs, found_index, head, start_index) {
-		if (!head->processing) {
-			found_head = true;
-			break;
-		}
-	}
-	if (!found_head) {
+	index = (delayed_refs->run_delayed_start >> fs_info->sectorsize_bits);
+	head = xa_find(&delayed_refs->head_refs, &index, ULONG_MAX,
+		       BTRFS_DELAYED_REF_HEAD_READY);
+	if (!head) {
 		if (delayed_refs->run_delayed_start == 0) {
 			spin_unlock(&delayed_refs->lock);
 			return NULL;
@@ -500,7 +501,9 @@ struct btrfs_delayed_ref_head *btrfs_select_ref_head(
 		goto again;
 	}
 
+	ASSERT(!head->processing);
 	head->processing = true;
+	xa_clear_mark(&delayed_refs->head_refs, index, BTRFS_DELAYED_REF_HEAD_READY);
 	WARN_ON(delayed_refs->num_heads_ready == 0);
 	delayed_refs->num_heads_ready--;
 	delayed_refs->run_delayed_start = head->bytenr +
@@ -520,11 +523,14 @@ struct btrfs_delayed_ref_head *btrfs_select_ref_head(
 	return head;
 }
 
-void btrfs_unselect_ref_head(struct btrfs_delayed_ref_root *delayed_refs,
+void btrfs_unselect_ref_head(const struct btrfs_fs_info *fs_info,
+			     struct btrfs_delayed_ref_root *delayed_refs,
 			     struct btrfs_delayed_ref_head *head)
 {
 	spin_lock(&delayed_refs->lock);
 	head->processing = false;
+	xa_set_mark(&delayed_refs->head_refs, head->bytenr >> fs_info->sectorsize_bits,
+		    BTRFS_DELAYED_REF_HEAD_READY);
 	delayed_refs->num_heads_ready++;
 	spin_unlock(&delayed_refs->lock);
 	btrfs_delayed_ref_unlock(head);
@@ -889,6 +895,7 @@ add_delayed_ref_head(struct btrfs_trans_handle *trans,
 			return ERR_PTR(-EEXIST);
 		}
 		head_ref->tracked = true;
+		xa_set_mark(&delayed_refs->head_refs, index, BTRFS_DELAYED_REF_HEAD_READY);
 		/*
 		 * We reserve the amount of bytes needed to delete csums when
 		 * adding the ref head and not when adding individual drop refs
@@ -209,6 +209,8 @@ struct btrfs_delayed_ref_root {
 	 * xarrays are of "unsigned long" type, meaning they are 32 bits wide on
 	 * 32 bits platforms, limiting the extent range to 4G which is too low
 	 * and makes it unusable (truncated index values) on 32 bits platforms.
+	 * Heads that are not being processed carry a mark, so that selecting
+	 * the next head skips the ones other tasks are running.
 	 * Protected by the spinlock 'lock' defined below.
 	 */
 	struct xarray head_refs;
@@ -402,7 +404,8 @@ void btrfs_delete_ref_head(const struct btrfs_fs_info *fs_info,
 struct btrfs_delayed_ref_head *btrfs_select_ref_head(
 		const struct btrfs_fs_info *fs_info,
 		struct btrfs_delayed_ref_root *delayed_refs);
-void btrfs_unselect_ref_head(struct btrfs_delayed_ref_root *delayed_refs,
+void btrfs_unselect_ref_head(const struct btrfs_fs_info *fs_info,
+			     struct btrfs_delayed_ref_root *delayed_refs,
 			     struct btrfs_delayed_ref_head *head);
 struct btrfs_delayed_ref_node *btrfs_select_delayed_ref(struct btrfs_delayed_ref_head *head);
 
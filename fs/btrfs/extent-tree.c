@@ -1945,7 +1945,7 @@ static int cleanup_ref_head(struct btrfs_trans_handle *trans,
 
 	ret = run_and_cleanup_extent_op(trans, head);
 	if (ret < 0) {
-		btrfs_unselect_ref_head(delayed_refs, head);
+		btrfs_unselect_ref_head(fs_info, delayed_refs, head);
 		btrfs_debug(fs_info, "run_delayed_extent_op returned %d", ret);
 		return ret;
 	} else if (ret) {
@@ -2014,7 +2014,7 @@ static int btrfs_run_delayed_refs_for_head(struct btrfs_trans_handle *trans,
 		if (ref->seq &&
 		    btrfs_check_delayed_seq(fs_info, ref->seq)) {
 			spin_unlock(&locked_ref->lock);
-			btrfs_unselect_ref_head(delayed_refs, locked_ref);
+			btrfs_unselect_ref_head(fs_info, delayed_refs, locked_ref);
 			return -EAGAIN;
 		}
 
@@ -2062,7 +2062,7 @@ static int btrfs_run_delayed_refs_for_head(struct btrfs_trans_handle *trans,
 
 		btrfs_free_delayed_extent_op(extent_op);
 		if (ret) {
-			btrfs_unselect_ref_head(delayed_refs, locked_ref);
+			btrfs_unselect_ref_head(fs_info, delayed_refs, locked_ref);
 			btrfs_put_delayed_ref(ref);
 			return ret;
 		}
@@ -469,6 +469,18 @@ struct btrfs_commit_stats {
 	u64 critical_section_start_time;
 };
 
+/* Store data about parallel data checksum verification, exported via sysfs. */
+struct btrfs_csum_verify_stats {
+	/* Read bios verified in parallel */
+	atomic64_t bios;
+	/* Chunks those bios were split into */
+	atomic64_t chunks;
+	/* Bytes verified in parallel */
+	atomic64_t bytes;
+	/* Large bios verified inline because of allocation failures */
+	atomic64_t fallbacks;
+};
+
 struct btrfs_delayed_root {
 	spinlock_t lock;
 	int nodes;		/* for delayed nodes */
@@ -692,6 +704,7 @@ struct btrfs_fs_info {
 	struct btrfs_workqueue *flush_workers;
 	struct workqueue_struct *endio_workers;
 	struct workqueue_struct *endio_meta_workers;
+	struct workqueue_struct *endio_csum_workers;
 	struct workqueue_struct *rmw_workers;
 	struct btrfs_workqueue *endio_write_workers;
 	struct btrfs_workqueue *endio_freespace_worker;
@@ -929,6 +942,8 @@ struct btrfs_fs_info {
 	/* Updates are not protected by any lock */
 	struct btrfs_commit_stats commit_stats;
 
+	struct btrfs_csum_verify_stats csum_verify_stats;
+
 	/*
 	 * Last generation where we dropped a non-relocation root.
 	 * Use btrfs_set_last_root_drop_gen() and btrfs_get_last_root_drop_gen()
@@ -1190,6 +1190,24 @@ static ssize_t btrfs_commit_stats_store(struct kobject *kobj,
 }
 BTRFS_ATTR_RW(, commit_stats, btrfs_commit_stats_show, btrfs_commit_stats_store);
 
+static ssize_t btrfs_csum_verify_stats_show(struct kobject *kobj,
+					    struct kobj_attribute *a, char *buf)
+{
+	struct btrfs_fs_info *fs_info = to_fs_info(kobj);
+	struct btrfs_csum_verify_stats *stats = &fs_info->csum_verify_stats;
+
+	return sysfs_emit(buf,
+		"parallel_bios %lld\n"
+		"parallel_chunks %lld\n"
+		"parallel_bytes %lld\n"
+		"fallbacks %lld\n",
+		atomic64_read(&stats->bios),
+		atomic64_read(&stats->chunks),
+		atomic64_read(&stats->bytes),
+		atomic64_read(&stats->fallbacks));
+}
+BTRFS_ATTR(, csum_verify_stats, btrfs_csum_verify_stats_show);
+
 static ssize_t btrfs_clone_alignment_show(struct kobject *kobj,
 				struct kobj_attribute *a, char *buf)
 {
@@ -1559,6 +1577,7 @@ static const struct attribute *btrfs_attrs[] = {
 	BTRFS_ATTR_PTR(, read_policy),
 	BTRFS_ATTR_PTR(, bg_reclaim_threshold),
 	BTRFS_ATTR_PTR(, commit_stats),
+	BTRFS_ATTR_PTR(, csum_verify_stats),
 	BTRFS_ATTR_PTR(, temp_fsid),
 	NULL,
 };
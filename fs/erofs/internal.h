@@ -113,6 +113,10 @@ struct erofs_sb_info {
 	struct xarray managed_pslots;
 
 	unsigned int sync_decompress;	/* strategy for sync decompression */
+	/* max workers a queue of pclusters is split across (0, 1: off) */
+	unsigned int decompress_fanout;
+	atomic_long_t decompress_queues;	/* queues seen with fanout on */
+	atomic_long_t decompress_fanout_parts;	/* parts handed to other workers */
 	unsigned int shrinker_run_no;
 
 	/* pseudo inode to manage cached pages */
@@ -15,6 +15,7 @@ enum {
 	attr_pointer_ui,
 	attr_pointer_bool,
 	attr_accel,
+	attr_decompress_stats,
 };
 
 enum {
@@ -60,6 +61,8 @@ static struct erofs_attr erofs_attr_##_name = {			\
 
 #ifdef CONFIG_EROFS_FS_ZIP
 EROFS_ATTR_RW_UI(sync_decompress, erofs_sb_info);
+EROFS_ATTR_RW_UI(decompress_fanout, erofs_sb_info);
+EROFS_ATTR_FUNC(decompress_stats, 0444);
 EROFS_ATTR_FUNC(drop_caches, 0200);
 #endif
 #ifdef CONFIG_EROFS_FS_ZIP_ACCEL
@@ -70,6 +73,8 @@ EROFS_ATTR_RW_UI(dir_ra_bytes, erofs_sb_info);
 static struct attribute *erofs_sb_attrs[] = {
 #ifdef CONFIG_EROFS_FS_ZIP
 	ATTR_LIST(sync_decompress),
+	ATTR_LIST(decompress_fanout),
+	ATTR_LIST(decompress_stats),
 	ATTR_LIST(drop_caches),
 #endif
 	ATTR_LIST(dir_ra_bytes),
@@ -145,6 +150,12 @@ static ssize_t erofs_attr_show(struct kobject *kobj,
 		return sysfs_emit(buf, "%d\n", *(bool *)ptr);
 	case attr_accel:
 		return z_erofs_crypto_show_engines(buf, PAGE_SIZE, '\n');
+#ifdef CONFIG_EROFS_FS_ZIP
+	case attr_decompress_stats:
+		return sysfs_emit(buf, "queues %ld\nfanout_parts %ld\n",
+				  atomic_long_read(&sbi->decompress_queues),
+				  atomic_long_read(&sbi->decompress_fanout_parts));
+#endif
 	}
 	return 0;
 }
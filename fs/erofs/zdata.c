@@ -287,6 +287,9 @@ static void z_erofs_free_pcluster(struct z_erofs_pcluster *pcl)
 
 static struct workqueue_struct *z_erofs_workqueue __read_mostly;
 
+/* minimum number of pclusters handed to each worker by decompress_fanout */
+#define Z_EROFS_FANOUT_MIN_PCLUSTERS	4
+
 #ifdef CONFIG_EROFS_FS_PCPU_KTHREAD
 static struct kthread_worker __rcu **z_erofs_pcpu_workers;
 static atomic_t erofs_percpu_workers_initialized = ATOMIC_INIT(0);
@@ -1412,6 +1415,63 @@ static int z_erofs_decompress_queue(const struct z_erofs_decompressqueue *io,
 	return err;
 }
 
+static void z_erofs_decompressqueue_work(struct work_struct *work);
+
+/*
+ * Split a long chain of pclusters into up to `decompress_fanout` parts of at
+ * least Z_EROFS_FANOUT_MIN_PCLUSTERS pclusters each, hand all but the first
+ * part to other workers, and keep the first part in @q.  Pclusters of a chain
+ * are independent and every worker uses its own decompressor context.
+ */
+static void z_erofs_fanout_queue(struct z_erofs_decompressqueue *q)
+{
+	struct erofs_sb_info *sbi = EROFS_SB(q->sb);
+	unsigned int fanout = min(READ_ONCE(sbi->decompress_fanout),
+				  num_online_cpus());
+	struct z_erofs_pcluster *pcl, *last, *head;
+	unsigned int nr = 0, per_part, i;
+
+	if (fanout < 2)
+		return;
+	atomic_long_inc(&sbi->decompress_queues);
+	for (pcl = q->head; pcl != Z_EROFS_PCLUSTER_TAIL; pcl = READ_ONCE(pcl->next))
+		++nr;
+	if (nr < 2 * Z_EROFS_FANOUT_MIN_PCLUSTERS)
+		return;
+	fanout = min(fanout, nr / Z_EROFS_FANOUT_MIN_PCLUSTERS);
+	per_part = DIV_ROUND_UP(nr, fanout);
+
+	/* the part kept in @q ends at @last */
+	last = q->head;
+	for (i = 1; i < per_part; ++i)
+		last = READ_ONCE(last->next);
+
+	while ((head = READ_ONCE(last->next)) != Z_EROFS_PCLUSTER_TAIL) {
+		struct z_erofs_decompressqueue *part;
+
+		/* on failure, the rest of the chain just stays in @q */
+		part = kvzalloc_obj(*part, GFP_NOIO | __GFP_NOWARN);
+		if (!part)
+			break;
+
+		pcl = head;
+		for (i = 1; i < per_part; ++i) {
+			if (READ_ONCE(pcl->next) == Z_EROFS_PCLUSTER_TAIL)
+				break;
+			pcl = READ_ONCE(pcl->next);
+		}
+		WRITE_ONCE(last->next, READ_ONCE(pcl->next));
+		WRITE_ONCE(pcl->next, Z_EROFS_PCLUSTER_TAIL);
+
+		part->sb = q->sb;
+		part->head = head;
+		part->eio = q->eio;
+		INIT_WORK(&part->u.work, z_erofs_decompressqueue_work);
+		queue_work(z_erofs_workqueue, &part->u.work);
+		atomic_long_inc(&sbi->decompress_fanout_parts);
+	}
+}
+
 static void z_erofs_decompressqueue_work(struct work_struct *work)
 {
 	struct z_erofs_decompressqueue *bgq =
@@ -1419,6 +1479,7 @@ static void z_erofs_decompressqueue_work(struct work_struct *work)
 	struct page *pagepool = NULL;
 
 	DBG_BUGON(bgq->head == Z_EROFS_PCLUSTER_TAIL);
+	z_erofs_fanout_queue(bgq);
 	z_erofs_decompress_queue(bgq, &pagepool);
 	erofs_release_pages(&pagepool);
 	kvfree(bgq);
@@ -15,6 +15,7 @@
 #include <linux/errno.h>
 #include <linux/mm.h>
 #include <linux/slab.h>
+#include <linux/vmalloc.h>
 #include <linux/poll.h>
 #include <linux/string.h>
 #include <linux/list.h>
@@ -85,6 +86,9 @@
 /* Epoll private bits inside the event mask */
 #define EP_PRIVATE_BITS (EPOLLWAKEUP | EPOLLONESHOT | EPOLLET | EPOLLEXCLUSIVE)
 
+/* Maximum number of entries of a ready ring */
+#define EP_RING_MAX_ENTRIES (1U << 16)
+
 #define EPOLLINOUT_BITS (EPOLLIN | EPOLLOUT)
 
 #define EPOLLEXCLUSIVE_OK_BITS (EPOLLINOUT_BITS | EPOLLERR | EPOLLHUP | \
@@ -215,6 +219,15 @@ struct eventpoll {
 
 	struct file *file;
 
+	/*
+	 * Ready ring shared with userspace, see EPIOCSRING. Set once, then
+	 * written under ->lock. The kernel keeps its own copy of mask and
+	 * tail, the mapped ones are only informational.
+	 */
+	struct epoll_ring *ring;
+	unsigned int ring_mask;
+	unsigned int ring_tail;
+
 	/* used to optimize loop detection check */
 	u64 gen;
 	struct hlist_head refs;
@@ -379,6 +392,14 @@ static inline struct epitem *ep_item_from_wait(wait_queue_entry_t *p)
 	return container_of(p, struct eppoll_entry, wait)->base;
 }
 
+/* Returns true if the ready ring holds entries not yet consumed */
+static inline bool ep_ring_pending(struct eventpoll *ep)
+{
+	struct epoll_ring *ring = READ_ONCE(ep->ring);
+
+	return ring && READ_ONCE(ring->head) != READ_ONCE(ep->ring_tail);
+}
+
 /**
  * ep_events_available - Checks if ready events might be available.
  *
@@ -390,7 +411,8 @@ static inline struct epitem *ep_item_from_wait(wait_queue_entry_t *p)
 static inline int ep_events_available(struct eventpoll *ep)
 {
 	return !list_empty_careful(&ep->rdllist) ||
-		READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR;
+		READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR ||
+		ep_ring_pending(ep);
 }
 
 #ifdef CONFIG_NET_RX_BUSY_POLL
@@ -819,6 +841,7 @@ static void ep_free(struct eventpoll *ep)
 	mutex_destroy(&ep->mtx);
 	free_uid(ep->user);
 	wakeup_source_unregister(ep->ws);
+	vfree(ep->ring);
 	kfree(ep);
 }
 
@@ -937,6 +960,97 @@ static void ep_clear_and_put(struct eventpoll *ep)
 		ep_free(ep);
 }
 
+static int ep_ring_setup(struct eventpoll *ep, void __user *uarg)
+{
+	struct epoll_ring_params params;
+	struct epoll_ring *ring;
+	unsigned int entries;
+	int ret = 0;
+
+	if (copy_from_user(&params, uarg, sizeof(params)))
+		return -EFAULT;
+	if (params.flags || params.__pad)
+		return -EINVAL;
+	if (!params.entries || params.entries > EP_RING_MAX_ENTRIES)
+		return -EINVAL;
+
+	entries = roundup_pow_of_two(params.entries);
+	ring = vmalloc_user(struct_size(ring, events, entries));
+	if (!ring)
+		return -ENOMEM;
+	ring->mask = entries - 1;
+
+	mutex_lock(&ep->mtx);
+	spin_lock_irq(&ep->lock);
+	if (!ep->ring) {
+		ep->ring_mask = entries - 1;
+		ep->ring_tail = 0;
+		WRITE_ONCE(ep->ring, ring);
+		ring = NULL;
+	} else {
+		ret = -EBUSY;
+	}
+	spin_unlock_irq(&ep->lock);
+	mutex_unlock(&ep->mtx);
+	vfree(ring);
+	if (ret)
+		return ret;
+
+	params.entries = entries;
+	if (copy_to_user(uarg, &params, sizeof(params)))
+		return -EFAULT;
+	return 0;
+}
+
+/*
+ * Publish the readiness of an edge-triggered item straight to the ready
+ * ring. Level-triggered items need to be polled again before being
+ * reported, and without a key we don't know what happened, so those go
+ * through the ready list. Must be called with ->lock held.
+ */
+static bool ep_ring_publish(struct eventpoll *ep, struct epitem *epi,
+			    __poll_t pollflags)
+{
+	struct epoll_ring *ring = ep->ring;
+	struct epoll_event *event;
+	unsigned int tail;
+
+	lockdep_assert_held(&ep->lock);
+
+	if (!ring || !pollflags || (pollflags & POLLFREE) ||
+	    !(epi->event.events & EPOLLET))
+		return false;
+
+	tail = ep->ring_tail;
+	if (tail - smp_load_acquire(&ring->head) > ep->ring_mask) {
+		WRITE_ONCE(ring->flags, READ_ONCE(ring->flags) | EPOLL_RING_OVERFLOW);
+		return false;
+	}
+
+	event = &ring->events[tail & ep->ring_mask];
+	event->events = pollflags & epi->event.events & ~EP_PRIVATE_BITS;
+	event->data = epi->event.data;
+	if (epi->event.events & EPOLLONESHOT)
+		epi->event.events &= EP_PRIVATE_BITS;
+
+	/* pairs with the userspace load-acquire of ->tail */
+	smp_store_release(&ring->tail, tail + 1);
+	WRITE_ONCE(ep->ring_tail, tail + 1);
+	return true;
+}
+
+static int ep_eventpoll_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct eventpoll *ep = file->private_data;
+	int ret = -EINVAL;
+
+	mutex_lock(&ep->mtx);
+	if (ep->ring)
+		ret = remap_vmalloc_range(vma, ep->ring, vma->vm_pgoff);
+	mutex_unlock(&ep->mtx);
+	return ret;
+}
+
 static long ep_eventpoll_ioctl(struct file *file, unsigned int cmd,
 			       unsigned long arg)
 {
@@ -950,6 +1064,9 @@ static long ep_eventpoll_ioctl(struct file *file, unsigned int cmd,
 	case EPIOCGPARAMS:
 		ret = ep_eventpoll_bp_ioctl(file, cmd, arg);
 		break;
+	case EPIOCSRING:
+		ret = ep_ring_setup(file->private_data, (void __user *)arg);
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -983,6 +1100,9 @@ static __poll_t __ep_eventpoll_poll(struct file *file, poll_table *wait, int dep
 	/* Insert inside our poll wait queue */
 	poll_wait(file, &ep->poll_wait, wait);
 
+	if (ep_ring_pending(ep))
+		return EPOLLIN | EPOLLRDNORM;
+
 	/*
 	 * Proceed to find out if wanted events are really available inside
 	 * the ready list.
@@ -1099,6 +1219,7 @@ static const struct file_operations eventpoll_fops = {
 #endif
 	.release	= ep_eventpoll_release,
 	.poll		= ep_eventpoll_poll,
+	.mmap		= ep_eventpoll_mmap,
 	.llseek		= noop_llseek,
 	.unlocked_ioctl	= ep_eventpoll_ioctl,
 	.compat_ioctl   = compat_ptr_ioctl,
@@ -1281,7 +1402,9 @@ static int ep_poll_callback(wait_queue_entry_t *wait, unsigned mode, int sync, v
 	 * semantics). All the events that happen during that period of time are
 	 * chained in ep->ovflist and requeued later on.
 	 */
-	if (READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR) {
+	if (ep_ring_publish(ep, epi, pollflags)) {
+		/* Delivered through the ready ring, nothing to queue. */
+	} else if (READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR) {
 		if (epi->next == EP_UNACTIVE_PTR) {
 			epi->next = READ_ONCE(ep->ovflist);
 			WRITE_ONCE(ep->ovflist, epi);
@@ -1972,7 +2095,8 @@ static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 				return res;
 		}
 
-		if (timed_out)
+		/* Let the caller drain the ready ring first. */
+		if (timed_out || ep_ring_pending(ep))
 			return 0;
 
 		eavail = ep_busy_loop(ep);
@@ -1165,6 +1165,19 @@ static int ext4_fc_perform_commit(journal_t *journal)
 	return ret;
 }
 
+static void ext4_fc_hist_add(unsigned long *hist, u64 time_ns)
+{
+	hist[min_t(unsigned int, fls64(div_u64(time_ns, NSEC_PER_USEC)),
+		   EXT4_FC_HIST_BUCKETS - 1)]++;
+}
+
+/* Account the time an ext4_fc_commit() caller spent, however it ended */
+static void ext4_fc_wait_done(struct super_block *sb, ktime_t start_time)
+{
+	ext4_fc_hist_add(EXT4_SB(sb)->s_fc_stats.fc_wait_hist,
+			 ktime_to_ns(ktime_sub(ktime_get(), start_time)));
+}
+
 static void ext4_fc_update_stats(struct super_block *sb, int status,
 				 u64 commit_time, int nblks, tid_t commit_tid)
 {
@@ -1181,6 +1194,7 @@ static void ext4_fc_update_stats(struct super_block *sb, int status,
 				 stats->s_fc_avg_commit_time * 3) / 4;
 		else
 			stats->s_fc_avg_commit_time = commit_time;
+		ext4_fc_hist_add(stats->fc_commit_hist, commit_time);
 	} else if (status == EXT4_FC_STATUS_FAILED ||
 		   status == EXT4_FC_STATUS_INELIGIBLE) {
 		if (status == EXT4_FC_STATUS_FAILED)
@@ -1225,6 +1239,7 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 			goto restart_fc;
 		ext4_fc_update_stats(sb, EXT4_FC_STATUS_SKIPPED, 0, 0,
 				commit_tid);
+		ext4_fc_wait_done(sb, start_time);
 		return 0;
 	} else if (ret) {
 		/*
@@ -1233,7 +1248,9 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 		 */
 		ext4_fc_update_stats(sb, EXT4_FC_STATUS_FAILED, 0, 0,
 				commit_tid);
-		return jbd2_complete_transaction(journal, commit_tid);
+		ret = jbd2_complete_transaction(journal, commit_tid);
+		ext4_fc_wait_done(sb, start_time);
+		return ret;
 	}
 
 	/*
@@ -1275,12 +1292,14 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 	 */
 	commit_time = ktime_to_ns(ktime_sub(ktime_get(), start_time));
 	ext4_fc_update_stats(sb, status, commit_time, nblks, commit_tid);
+	ext4_fc_hist_add(sbi->s_fc_stats.fc_wait_hist, commit_time);
 	return ret;
 
 fallback:
 	set_task_ioprio(current, old_ioprio);
 	ret = jbd2_fc_end_commit_fallback(journal);
 	ext4_fc_update_stats(sb, status, 0, 0, commit_tid);
+	ext4_fc_wait_done(sb, start_time);
 	return ret;
 }
 
@@ -2333,6 +2352,15 @@ int ext4_fc_info_show(struct seq_file *seq, void *v)
 	for (i = 0; i < EXT4_FC_REASON_MAX; i++)
 		seq_printf(seq, "\"%s\":\t%d\n", fc_ineligible_reasons[i],
 			stats->fc_ineligible_reason_count[i]);
+	seq_printf(seq, "%lu failed\n%lu skipped\n",
+		   stats->fc_failed_commits, stats->fc_skipped_commits);
+	seq_puts(seq, "Latency histograms (us, log2 buckets):\n");
+	seq_puts(seq, "bucket\tcommit\twait\n");
+	for (i = 0; i < EXT4_FC_HIST_BUCKETS - 1; i++)
+		seq_printf(seq, "<%lu\t%lu\t%lu\n", 1UL << i,
+			   stats->fc_commit_hist[i], stats->fc_wait_hist[i]);
+	seq_printf(seq, ">=%lu\t%lu\t%lu\n", 1UL << (i - 1),
+		   stats->fc_commit_hist[i], stats->fc_wait_hist[i]);
 
 	return 0;
 }
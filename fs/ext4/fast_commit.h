@@ -117,6 +117,12 @@ struct ext4_fc_dentry_update {
 	struct list_head fcd_dilist;
 };
 
+/*
+ * Latency histograms in fc_info: bucket i counts [2^(i-1), 2^i) us, the last
+ * bucket everything above.
+ */
+#define EXT4_FC_HIST_BUCKETS	20
+
 struct ext4_fc_stats {
 	unsigned int fc_ineligible_reason_count[EXT4_FC_REASON_MAX];
 	unsigned long fc_num_commits;
@@ -125,6 +131,14 @@ struct ext4_fc_stats {
 	unsigned long fc_skipped_commits;
 	unsigned long fc_numblks;
 	u64 s_fc_avg_commit_time;
+	/* time taken by the fast commits performed */
+	unsigned long fc_commit_hist[EXT4_FC_HIST_BUCKETS];
+	/*
+	 * time ext4_fc_commit() callers waited, including those that found
+	 * their changes committed by a concurrent fast commit and those that
+	 * fell back to a full commit
+	 */
+	unsigned long fc_wait_hist[EXT4_FC_HIST_BUCKETS];
 };
 
 #define EXT4_FC_REPLAY_REALLOC_INCREMENT	4
@@ -2958,13 +2958,17 @@ static int ext4_mb_scan_group(struct ext4_allocation_context *ac,
 {
 	int ret;
 	struct super_block *sb = ac->ac_sb;
+	struct ext4_sb_info *sbi = EXT4_SB(sb);
 	enum criteria cr = ac->ac_criteria;
 
 	ext4_mb_might_prefetch(ac, group);
 
 	/* prevent unnecessary buddy loading. */
-	if (cr < CR_ANY_FREE && spin_is_locked(ext4_group_lock_ptr(sb, group)))
+	if (cr < CR_ANY_FREE && spin_is_locked(ext4_group_lock_ptr(sb, group))) {
+		if (sbi->s_mb_stats)
+			atomic64_inc(&sbi->s_bal_busy_skipped);
 		return 0;
+	}
 
 	/* This now checks without needing the buddy folio */
 	ret = ext4_mb_good_group_nolock(ac, group, cr);
@@ -2979,10 +2983,17 @@ static int ext4_mb_scan_group(struct ext4_allocation_context *ac,
 		return ret;
 
 	/* skip busy group */
-	if (cr >= CR_ANY_FREE)
-		ext4_lock_group(sb, group);
-	else if (!ext4_try_lock_group(sb, group))
+	if (cr >= CR_ANY_FREE) {
+		if (!ext4_try_lock_group(sb, group)) {
+			if (sbi->s_mb_stats)
+				atomic64_inc(&sbi->s_bal_lock_waits);
+			ext4_lock_group(sb, group);
+		}
+	} else if (!ext4_try_lock_group(sb, group)) {
+		if (sbi->s_mb_stats)
+			atomic64_inc(&sbi->s_bal_busy_skipped);
 		goto out_unload;
+	}
 
 	/* We need to check again after locking the block group. */
 	if (unlikely(!ext4_mb_good_group(ac, group, cr)))
@@ -3296,6 +3307,13 @@ int ext4_seq_mb_stats_show(struct seq_file *seq, void *offset)
 	seq_printf(seq, "\t\t2^n_hits: %u\n", atomic_read(&sbi->s_bal_2orders));
 	seq_printf(seq, "\t\tbreaks: %u\n", atomic_read(&sbi->s_bal_breaks));
 	seq_printf(seq, "\t\tlost: %u\n", atomic_read(&sbi->s_mb_lost_chunks));
+	seq_puts(seq, "\tcontention:\n");
+	seq_printf(seq, "\t\tbusy_groups_skipped: %llu\n",
+		   atomic64_read(&sbi->s_bal_busy_skipped));
+	seq_printf(seq, "\t\tgroup_lock_waits: %llu\n",
+		   atomic64_read(&sbi->s_bal_lock_waits));
+	seq_printf(seq, "\t\tlock_busy_level: %d\n",
+		   atomic_read(&sbi->s_lock_busy));
 	seq_printf(seq, "\tbuddies_generated: %u/%u\n",
 		   atomic_read(&sbi->s_mb_buddies_generated),
 		   ext4_get_groups_count(sb));
@@ -18,6 +18,7 @@ MODULE_PARM_DESC(enable_uring,
 		 "Enable userspace communication through io-uring");
 
 #define FUSE_URING_IOV_SEGS 2 /* header and payload */
+#define FUSE_URING_DISPATCH_BATCH 16 /* max entries handed requests at once */
 
 
 bool fuse_uring_enabled(void)
@@ -30,6 +31,8 @@ struct fuse_uring_pdu {
 };
 
 static const struct fuse_iqueue_ops fuse_io_uring_ops;
+static void fuse_uring_dispatch_queued(struct fuse_ring_queue *queue,
+				       unsigned int keep);
 
 static void uring_cmd_set_ring_ent(struct io_uring_cmd *cmd,
 				   struct fuse_ring_ent *ring_ent)
@@ -48,10 +51,12 @@ static struct fuse_ring_ent *uring_cmd_to_ring_ent(struct io_uring_cmd *cmd)
 	return pdu->ent;
 }
 
-static void fuse_uring_flush_bg(struct fuse_ring_queue *queue)
+/* Returns the number of requests moved to the fuse_req_queue */
+static unsigned int fuse_uring_flush_bg(struct fuse_ring_queue *queue)
 {
 	struct fuse_ring *ring = queue->ring;
 	struct fuse_conn *fc = ring->fc;
+	unsigned int moved = 0;
 
 	lockdep_assert_held(&queue->lock);
 	lockdep_assert_held(&fc->bg_lock);
@@ -73,7 +78,10 @@ static void fuse_uring_flush_bg(struct fuse_ring_queue *queue)
 		queue->active_background++;
 
 		list_move_tail(&req->list, &queue->fuse_req_queue);
+		moved++;
 	}
+
+	return moved;
 }
 
 static void fuse_uring_req_end(struct fuse_ring_ent *ent, struct fuse_req *req,
@@ -82,6 +90,7 @@ static void fuse_uring_req_end(struct fuse_ring_ent *ent, struct fuse_req *req,
 	struct fuse_ring_queue *queue = ent->queue;
 	struct fuse_ring *ring = queue->ring;
 	struct fuse_conn *fc = ring->fc;
+	unsigned int moved = 0;
 
 	lockdep_assert_not_held(&queue->lock);
 	spin_lock(&queue->lock);
@@ -90,11 +99,19 @@ static void fuse_uring_req_end(struct fuse_ring_ent *ent, struct fuse_req *req,
 	if (test_bit(FR_BACKGROUND, &req->flags)) {
 		queue->active_background--;
 		spin_lock(&fc->bg_lock);
-		fuse_uring_flush_bg(queue);
+		moved = fuse_uring_flush_bg(queue);
 		spin_unlock(&fc->bg_lock);
 	}
 
-	spin_unlock(&queue->lock);
+	/*
+	 * Released background limits may have let several requests through.
+	 * The entry being committed fetches one of them, hand the others to
+	 * idle entries instead of leaving them queued.
+	 */
+	if (moved > 1)
+		fuse_uring_dispatch_queued(queue, 1);
+	else
+		spin_unlock(&queue->lock);
 
 	if (error)
 		req->out.h.error = error;
@@ -1262,6 +1279,44 @@ static void fuse_uring_dispatch_ent(struct fuse_ring_ent *ent)
 	io_uring_cmd_complete_in_task(cmd, fuse_uring_send_in_task);
 }
 
+/*
+ * Hand queued requests to available ring entries, leaving @keep requests on
+ * the queue.  Called with the queue lock held, which is released.
+ */
+static void fuse_uring_dispatch_queued(struct fuse_ring_queue *queue,
+				       unsigned int keep)
+	__releases(&queue->lock)
+{
+	struct fuse_ring_ent *ents[FUSE_URING_DISPATCH_BATCH];
+	unsigned int nr_ents = 0, nr_reqs = 0, i;
+	struct fuse_ring_ent *ent;
+	struct fuse_req *req;
+
+	lockdep_assert_held(&queue->lock);
+
+	list_for_each_entry(req, &queue->fuse_req_queue, list) {
+		if (++nr_reqs > keep + FUSE_URING_DISPATCH_BATCH)
+			break;
+	}
+
+	while (!queue->stopped && nr_reqs > keep &&
+	       nr_ents < FUSE_URING_DISPATCH_BATCH) {
+		ent = list_first_entry_or_null(&queue->ent_avail_queue,
+					       struct fuse_ring_ent, list);
+		if (!ent)
+			break;
+		req = list_first_entry(&queue->fuse_req_queue, struct fuse_req,
+				       list);
+		fuse_uring_add_req_to_ring_ent(ent, req);
+		ents[nr_ents++] = ent;
+		nr_reqs--;
+	}
+	spin_unlock(&queue->lock);
+
+	for (i = 0; i < nr_ents; i++)
+		fuse_uring_dispatch_ent(ents[i]);
+}
+
 /* queue a fuse request and send it if a ring entry is available */
 void fuse_uring_queue_fuse_req(struct fuse_iqueue *fiq, struct fuse_req *req)
 {
@@ -1311,7 +1366,6 @@ bool fuse_uring_queue_bq_req(struct fuse_req *req)
 	struct fuse_conn *fc = req->fm->fc;
 	struct fuse_ring *ring = fc->ring;
 	struct fuse_ring_queue *queue;
-	struct fuse_ring_ent *ent = NULL;
 
 	queue = fuse_uring_task_to_queue(ring);
 	if (!queue)
@@ -1327,8 +1381,6 @@ bool fuse_uring_queue_bq_req(struct fuse_req *req)
 	req->ring_queue = queue;
 	list_add_tail(&req->list, &queue->fuse_req_bg_queue);
 
-	ent = list_first_entry_or_null(&queue->ent_avail_queue,
-				       struct fuse_ring_ent, list);
 	spin_lock(&fc->bg_lock);
 	fc->num_background++;
 	if (fc->num_background == fc->max_background)
@@ -1338,19 +1390,11 @@ bool fuse_uring_queue_bq_req(struct fuse_req *req)
 
 	/*
 	 * Due to bg_queue flush limits there might be other bg requests
-	 * in the queue that need to be handled first. Or no further req
-	 * might be available.
+	 * in the queue that need to be handled first, or several of them
+	 * may have been let through at once. Or no further req might be
+	 * available.
 	 */
-	req = list_first_entry_or_null(&queue->fuse_req_queue, struct fuse_req,
-				       list);
-	if (ent && req) {
-		fuse_uring_add_req_to_ring_ent(ent, req);
-		spin_unlock(&queue->lock);
-
-		fuse_uring_dispatch_ent(ent);
-	} else {
-		spin_unlock(&queue->lock);
-	}
+	fuse_uring_dispatch_queued(queue, 0);
 
 	return true;
 }
@@ -1546,6 +1546,16 @@ static int fuse_update_get_attr(struct mnt_idmap *idmap, struct inode *inode,
 	else
 		sync = time_before64(fi->i_time, get_jiffies_64());
 
+	/*
+	 * Attributes that only timed out may be answered from the backing
+	 * inode of a passthrough inode, if the server allowed that.
+	 */
+	if (IS_ENABLED(CONFIG_FUSE_PASSTHROUGH) && sync && stat &&
+	    !(flags & AT_STATX_FORCE_SYNC) &&
+	    !(request_mask & inval_mask & ~cache_mask) &&
+	    !fuse_passthrough_getattr(idmap, inode, stat, request_mask))
+		return 0;
+
 	if (sync) {
 		forget_all_cached_acls(inode);
 		/* Try statx if BTIME is requested */
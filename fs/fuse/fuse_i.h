@@ -108,6 +108,9 @@ struct fuse_backing {
 	struct file *file;
 	struct cred *cred;
 
+	/** FUSE_BACKING_* flags from the backing map */
+	u32 flags;
+
 	/** refcount */
 	refcount_t count;
 	struct rcu_head rcu;
@@ -1615,6 +1618,8 @@ ssize_t fuse_passthrough_splice_write(struct pipe_inode_info *pipe,
 				      struct file *out, loff_t *ppos,
 				      size_t len, unsigned int flags);
 ssize_t fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma);
+int fuse_passthrough_getattr(struct mnt_idmap *idmap, struct inode *inode,
+			     struct kstat *stat, u32 request_mask);
 
 #ifdef CONFIG_SYSCTL
 extern int fuse_sysctl_register(void);
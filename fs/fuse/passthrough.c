@@ -144,6 +144,56 @@ ssize_t fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma)
 	return backing_file_mmap(backing_file, vma, &ctx);
 }
 
+/*
+ * Answer getattr of an inode in passthrough mode from its backing inode, if the
+ * server allowed that with FUSE_BACKING_ATTR.  Ownership, mode, link count and
+ * inode number come from the last server reply, size, blocks and timestamps
+ * from the backing inode that passthrough I/O goes to.
+ *
+ * Returns -ENOENT if the attributes have to be fetched from the server.
+ */
+int fuse_passthrough_getattr(struct mnt_idmap *idmap, struct inode *inode,
+			     struct kstat *stat, u32 request_mask)
+{
+	struct fuse_inode *fi = get_fuse_inode(inode);
+	struct fuse_backing *fb;
+	struct kstat bstat;
+	int err = -ENOENT;
+
+	rcu_read_lock();
+	fb = fuse_backing_get(fuse_inode_backing(fi));
+	rcu_read_unlock();
+	if (!fb)
+		return -ENOENT;
+
+	if (!(fb->flags & FUSE_BACKING_ATTR))
+		goto out;
+
+	scoped_with_creds(fb->cred)
+		err = vfs_getattr(&fb->file->f_path, &bstat, request_mask,
+				  AT_STATX_SYNC_AS_STAT);
+	if (err)
+		goto out;
+
+	generic_fillattr(idmap, request_mask, inode, stat);
+	stat->mode = fi->orig_i_mode;
+	stat->ino = fi->orig_ino;
+	stat->size = bstat.size;
+	stat->blocks = bstat.blocks;
+	stat->blksize = bstat.blksize;
+	stat->atime = bstat.atime;
+	stat->mtime = bstat.mtime;
+	stat->ctime = bstat.ctime;
+	if (bstat.result_mask & STATX_BTIME) {
+		stat->btime = bstat.btime;
+		stat->result_mask |= STATX_BTIME;
+	}
+out:
+	pr_debug("%s: fb=0x%p, err=%i\n", __func__, fb, err);
+	fuse_backing_put(fb);
+	return err;
+}
+
 /*
  * Setup passthrough to a backing file.
  *
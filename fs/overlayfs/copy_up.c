@@ -269,6 +269,7 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 	loff_t data_pos = -1;
 	loff_t hole_len;
 	bool skip_hole = false;
+	bool offload;
 	int error = 0;
 
 	ovl_path_lowerdata(dentry, &datapath);
@@ -296,6 +297,15 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 	if (old_file->f_mode & FMODE_LSEEK)
 		skip_hole = true;
 
+	/*
+	 * Let an upper fs that can offload copies (e.g. server side copy on
+	 * nfs or cifs) copy the data without moving it through the page cache.
+	 * vfs_copy_file_range() only calls ->copy_file_range() if the lower
+	 * file shares it and the fs checks pass. Falls back to splice on the
+	 * first chunk it refuses.
+	 */
+	offload = new_file->f_op->copy_file_range;
+
 	while (len) {
 		size_t this_len = OVL_COPY_UP_CHUNK_SIZE;
 		ssize_t bytes;
@@ -346,6 +356,19 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 		if (error)
 			break;
 
+		if (offload) {
+			bytes = vfs_copy_file_range(old_file, old_pos,
+						    new_file, new_pos,
+						    this_len, 0);
+			if (bytes > 0) {
+				old_pos += bytes;
+				new_pos += bytes;
+				len -= bytes;
+				continue;
+			}
+			offload = false;
+		}
+
 		bytes = do_splice_direct(old_file, &old_pos,
 					 new_file, &new_pos,
 					 this_len, SPLICE_F_MOVE);
@@ -31,20 +31,20 @@ struct kmem_cache *xfs_buf_cache;
  *
  * xfs_buf_stale:
  *	b_sema (caller holds)
- *	  b_lock
+ *	  b_lockref.lock
  *	    lru_lock
  *
  * xfs_buf_rele:
- *	b_lock
+ *	b_lockref.lock
  *	  lru_lock
  *
  * xfs_buftarg_drain_rele
  *	lru_lock
- *	  b_lock (trylock due to inversion)
+ *	  b_lockref.lock (trylock due to inversion)
  *
  * xfs_buftarg_isolate
  *	lru_lock
- *	  b_lock (trylock due to inversion)
+ *	  b_lockref.lock (trylock due to inversion)
  */
 
 static void xfs_buf_submit(struct xfs_buf *bp);
@@ -78,14 +78,14 @@ xfs_buf_stale(
 	 */
 	bp->b_flags &= ~_XBF_DELWRI_Q;
 
-	spin_lock(&bp->b_lock);
+	spin_lock(&bp->b_lockref.lock);
 	atomic_set(&bp->b_lru_ref, 0);
 	if (!(bp->b_state & XFS_BSTATE_DISPOSE) &&
 	    (list_lru_del_obj(&bp->b_target->bt_lru, &bp->b_lru)))
-		bp->b_hold--;
+		bp->b_lockref.count--;
 
-	ASSERT(bp->b_hold >= 1);
-	spin_unlock(&bp->b_lock);
+	ASSERT(bp->b_lockref.count >= 1);
+	spin_unlock(&bp->b_lockref.lock);
 }
 
 static void
@@ -277,10 +277,10 @@ xfs_buf_alloc(
 	 * inserting into the hash table are safe (and will have to wait for
 	 * the unlock to do anything non-trivial).
 	 */
-	bp->b_hold = 1;
+	bp->b_lockref.count = 1;
 	sema_init(&bp->b_sema, 0); /* held, no waiters */
 
-	spin_lock_init(&bp->b_lock);
+	spin_lock_init(&bp->b_lockref.lock);
 	atomic_set(&bp->b_lru_ref, 1);
 	init_completion(&bp->b_iowait);
 	INIT_LIST_HEAD(&bp->b_lru);
@@ -437,18 +437,15 @@ xfs_buf_find_lock(
 	return 0;
 }
 
+/*
+ * Take a reference to a buffer found by an RCU lookup.  A buffer with a zero
+ * reference count is being freed and must not be used.
+ */
 static bool
 xfs_buf_try_hold(
 	struct xfs_buf		*bp)
 {
-	spin_lock(&bp->b_lock);
-	if (bp->b_hold == 0) {
-		spin_unlock(&bp->b_lock);
-		return false;
-	}
-	bp->b_hold++;
-	spin_unlock(&bp->b_lock);
-	return true;
+	return lockref_get_not_zero(&bp->b_lockref);
 }
 
 static inline int
@@ -856,9 +853,7 @@ xfs_buf_hold(
 {
 	trace_xfs_buf_hold(bp, _RET_IP_);
 
-	spin_lock(&bp->b_lock);
-	bp->b_hold++;
-	spin_unlock(&bp->b_lock);
+	lockref_get(&bp->b_lockref);
 }
 
 static void
@@ -867,12 +862,10 @@ xfs_buf_rele_uncached(
 {
 	ASSERT(list_empty(&bp->b_lru));
 
-	spin_lock(&bp->b_lock);
-	if (--bp->b_hold) {
-		spin_unlock(&bp->b_lock);
+	if (lockref_put_or_lock(&bp->b_lockref))
 		return;
-	}
-	spin_unlock(&bp->b_lock);
+	bp->b_lockref.count--;
+	spin_unlock(&bp->b_lockref.lock);
 	xfs_buf_free(bp);
 }
 
@@ -887,14 +880,15 @@ xfs_buf_rele_cached(
 
 	trace_xfs_buf_rele(bp, _RET_IP_);
 
-	spin_lock(&bp->b_lock);
-	ASSERT(bp->b_hold >= 1);
-	if (bp->b_hold > 1) {
-		bp->b_hold--;
-		goto out_unlock;
-	}
+	/*
+	 * Dropping a reference other than the last one needs no locking,
+	 * otherwise we get here with b_lockref.lock held.
+	 */
+	if (lockref_put_or_lock(&bp->b_lockref))
+		return;
 
 	/* we are asked to drop the last reference */
+	ASSERT(bp->b_lockref.count == 1);
 	if (atomic_read(&bp->b_lru_ref)) {
 		/*
 		 * If the buffer is added to the LRU, keep the reference to the
@@ -904,9 +898,9 @@ xfs_buf_rele_cached(
 		if (list_lru_add_obj(&btp->bt_lru, &bp->b_lru))
 			bp->b_state &= ~XFS_BSTATE_DISPOSE;
 		else
-			bp->b_hold--;
+			bp->b_lockref.count--;
 	} else {
-		bp->b_hold--;
+		bp->b_lockref.count--;
 		/*
 		 * most of the time buffers will already be removed from the
 		 * LRU, so optimise that case by checking for the
@@ -927,8 +921,7 @@ xfs_buf_rele_cached(
 		freebuf = true;
 	}
 
-out_unlock:
-	spin_unlock(&bp->b_lock);
+	spin_unlock(&bp->b_lockref.lock);
 
 	if (freebuf)
 		xfs_buf_free(bp);
@@ -1512,11 +1505,11 @@ xfs_buftarg_drain_rele(
 	struct xfs_buf		*bp = container_of(item, struct xfs_buf, b_lru);
 	struct list_head	*dispose = arg;
 
-	if (!spin_trylock(&bp->b_lock))
+	if (!spin_trylock(&bp->b_lockref.lock))
 		return LRU_SKIP;
-	if (bp->b_hold > 1) {
+	if (bp->b_lockref.count > 1) {
 		/* need to wait, so skip it this pass */
-		spin_unlock(&bp->b_lock);
+		spin_unlock(&bp->b_lockref.lock);
 		trace_xfs_buf_drain_buftarg(bp, _RET_IP_);
 		return LRU_SKIP;
 	}
@@ -1528,7 +1521,7 @@ xfs_buftarg_drain_rele(
 	atomic_set(&bp->b_lru_ref, 0);
 	bp->b_state |= XFS_BSTATE_DISPOSE;
 	list_lru_isolate_move(lru, item, dispose);
-	spin_unlock(&bp->b_lock);
+	spin_unlock(&bp->b_lockref.lock);
 	return LRU_REMOVED;
 }
 
@@ -1610,10 +1603,10 @@ xfs_buftarg_isolate(
 	struct list_head	*dispose = arg;
 
 	/*
-	 * we are inverting the lru lock/bp->b_lock here, so use a trylock.
+	 * we are inverting the lru lock/bp->b_lockref.lock here, so use a trylock.
 	 * If we fail to get the lock, just skip it.
 	 */
-	if (!spin_trylock(&bp->b_lock))
+	if (!spin_trylock(&bp->b_lockref.lock))
 		return LRU_SKIP;
 	/*
 	 * Decrement the b_lru_ref count unless the value is already
@@ -1621,13 +1614,13 @@ xfs_buftarg_isolate(
 	 * buffer, otherwise it gets another trip through the LRU.
 	 */
 	if (atomic_add_unless(&bp->b_lru_ref, -1, 0)) {
-		spin_unlock(&bp->b_lock);
+		spin_unlock(&bp->b_lockref.lock);
 		return LRU_ROTATE;
 	}
 
 	bp->b_state |= XFS_BSTATE_DISPOSE;
 	list_lru_isolate_move(lru, item, dispose);
-	spin_unlock(&bp->b_lock);
+	spin_unlock(&bp->b_lockref.lock);
 	return LRU_REMOVED;
 }
 
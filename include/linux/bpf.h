@@ -178,6 +178,7 @@ struct bpf_map_ops {
 				     void *callback_ctx, u64 flags);
 
 	u64 (*map_mem_usage)(const struct bpf_map *map);
+	void (*map_show_fdinfo)(const struct bpf_map *map, struct seq_file *m);
 
 	/* BTF id of struct allocated by map_alloc */
 	int *map_btf_id;
@@ -1723,6 +1724,7 @@ struct bpf_prog_aux {
 	struct bpf_prog *prog;
 	struct user_struct *user;
 	u64 load_time; /* ns since boottime */
+	u64 verification_time; /* ns spent in bpf_check() */
 	u32 verified_insns;
 	int cgroup_atype; /* enum cgroup_bpf_attach_type */
 	struct bpf_map *cgroup_storage[MAX_BPF_CGROUP_STORAGE_TYPE];
@@ -1203,8 +1203,14 @@ struct fown_struct {
  *      the first of these pages is accessed.
  * @ra_pages: Maximum size of a readahead request, copied from the bdi.
  * @order: Preferred folio order used for most recent readahead.
+ * @pattern: Access pattern the readahead code classified the reads as,
+ *      together with how many times in a row it has been seen.
  * @mmap_miss: How many mmap accesses missed in the page cache.
  * @prev_pos: The last byte in the most recent read request.
+ * @nr_sync: Readahead started because of a page cache miss.
+ * @nr_async: Readahead started because a PG_readahead folio was hit.
+ * @nr_pages: Pages added to the page cache by readahead.
+ * @nr_large_pages: The subset of @nr_pages that went into large folios.
  *
  * When this structure is passed to ->readahead(), the "most recent"
  * readahead means the current readahead.
@@ -1214,9 +1220,16 @@ struct file_ra_state {
 	unsigned int size;
 	unsigned int async_size;
 	unsigned int ra_pages;
-	unsigned short order;
+	unsigned char order;
+	unsigned char pattern;
 	unsigned short mmap_miss;
 	loff_t prev_pos;
+#ifdef CONFIG_READAHEAD_STATS
+	unsigned int nr_sync;
+	unsigned int nr_async;
+	unsigned long nr_pages;
+	unsigned long nr_large_pages;
+#endif
 };
 
 /*
@@ -3072,6 +3085,7 @@ extern ssize_t iter_file_splice_write(struct pipe_inode_info *,
 
 extern void
 file_ra_state_init(struct file_ra_state *ra, struct address_space *mapping);
+extern void file_ra_show_fdinfo(struct seq_file *m, struct file *file);
 extern loff_t noop_llseek(struct file *file, loff_t offset, int whence);
 extern loff_t vfs_setpos(struct file *file, loff_t offset, loff_t maxsize);
 extern loff_t generic_file_llseek(struct file *file, loff_t offset, int whence);
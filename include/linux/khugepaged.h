@@ -31,6 +31,26 @@ static inline void khugepaged_exit(struct mm_struct *mm)
 	if (mm_flags_test(MMF_VM_HUGEPAGE, mm))
 		__khugepaged_exit(mm);
 }
+
+/*
+ * Called when a fault is about to populate an empty PMD with a PTE table.
+ * Remember the range so khugepaged looks at it before it gets there in its
+ * linear walk of the mm.
+ */
+static inline void khugepaged_fault_hint(struct vm_area_struct *vma,
+					 unsigned long address)
+{
+	struct mm_struct *mm = vma->vm_mm;
+	unsigned int idx;
+
+	if (!mm_flags_test(MMF_VM_HUGEPAGE, mm) || !vma_is_anonymous(vma))
+		return;
+
+	idx = READ_ONCE(mm->khugepaged_hint_next);
+	WRITE_ONCE(mm->khugepaged_hint_next, idx + 1);
+	WRITE_ONCE(mm->khugepaged_hints[idx % MM_KHUGEPAGED_HINTS],
+		   address & HPAGE_PMD_MASK);
+}
 #else /* CONFIG_TRANSPARENT_HUGEPAGE */
 static inline void khugepaged_fork(struct mm_struct *mm, struct mm_struct *oldmm)
 {
@@ -38,6 +58,10 @@ static inline void khugepaged_fork(struct mm_struct *mm, struct mm_struct *oldmm
 static inline void khugepaged_exit(struct mm_struct *mm)
 {
 }
+static inline void khugepaged_fault_hint(struct vm_area_struct *vma,
+					 unsigned long address)
+{
+}
 static inline void khugepaged_enter_vma(struct vm_area_struct *vma,
 					vm_flags_t vm_flags)
 {
@@ -1118,6 +1118,9 @@ typedef struct {
 	DECLARE_BITMAP(__mm_flags, NUM_MM_FLAG_BITS);
 } __private mm_flags_t;
 
+/* Number of fault-fed PMD hints khugepaged keeps per mm. */
+#define MM_KHUGEPAGED_HINTS 8
+
 struct kioctx_table;
 struct iommu_mm_data;
 struct mm_struct {
@@ -1299,6 +1302,16 @@ struct mm_struct {
 #if defined(CONFIG_TRANSPARENT_HUGEPAGE) && !defined(CONFIG_SPLIT_PMD_PTLOCKS)
 		pgtable_t pmd_huge_pte; /* protected by page_table_lock */
 #endif
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+		/*
+		 * PMD-aligned addresses that recently had a PTE table
+		 * populated by a page fault. khugepaged consumes these
+		 * before resuming its linear scan of the mm. Updated
+		 * locklessly; a lost or stale hint is harmless.
+		 */
+		unsigned long khugepaged_hints[MM_KHUGEPAGED_HINTS];
+		unsigned int khugepaged_hint_next;
+#endif
 #ifdef CONFIG_NUMA_BALANCING
 		/*
 		 * numa_next_scan is the next time that PTEs will be remapped
@@ -754,6 +754,10 @@ struct per_cpu_pages {
 	u8 expire;		/* When 0, remote pagesets are drained */
 #endif
 	short free_count;	/* consecutive free count */
+	int nr_alloc;		/* pages refilled from buddy this interval */
+	int nr_free;		/* pages freed to buddy this interval */
+	int alloc_rate;		/* EWMA of nr_alloc per vmstat interval */
+	int free_rate;		/* EWMA of nr_free per vmstat interval */
 
 	/* Lists of pages, one per migrate type stored on the pcp-lists */
 	struct list_head lists[NR_PCP_LISTS];
@@ -339,6 +339,8 @@ enum netdev_state_t {
 struct gro_list {
 	struct list_head	list;
 	int			count;
+	u16			seen;	/* skbs since the last flush of the bucket */
+	u16			rate;	/* EWMA of @seen, scaled by 8 */
 };
 
 /*
@@ -354,6 +356,7 @@ struct gro_list {
  * @rx_list: list of pending ``GRO_NORMAL`` skbs
  * @rx_count: cached current length of @rx_list
  * @cached_napi_id: napi_struct::napi_id cached for hotpath, 0 for standalone
+ * @rate_mask: buckets with a non-zero &gro_list.seen or &gro_list.rate
  */
 struct gro_node {
 	unsigned long		bitmask;
@@ -361,6 +364,7 @@ struct gro_node {
 	struct list_head	rx_list;
 	u32			rx_count;
 	u32			cached_napi_id;
+	unsigned long		rate_mask;
 };
 
 /*
@@ -3379,6 +3383,8 @@ u16 dev_pick_tx_zero(struct net_device *dev, struct sk_buff *skb,
 
 int __dev_queue_xmit(struct sk_buff *skb, struct net_device *sb_dev);
 int __dev_direct_xmit(struct sk_buff *skb, u16 queue_id);
+struct sk_buff *__dev_direct_xmit_list(struct sk_buff *skb, u16 queue_id,
+				       int *ret);
 
 static inline int dev_queue_xmit(struct sk_buff *skb)
 {
@@ -3526,6 +3532,8 @@ struct softnet_data {
 #endif
 
 	unsigned int		received_rps;
+	unsigned int		defer_drops;
+	unsigned int		defer_ipis;
 	bool			in_net_rx_action;
 	bool			in_napi_threaded_poll;
 
@@ -183,12 +183,12 @@ extern void padata_free_shell(struct padata_shell *ps);
 extern int padata_do_parallel(struct padata_shell *ps,
 			      struct padata_priv *padata, int *cb_cpu);
 extern void padata_do_serial(struct padata_priv *padata);
-extern void __init padata_do_multithreaded(struct padata_mt_job *job);
+extern void padata_do_multithreaded(struct padata_mt_job *job);
 extern int padata_set_cpumask(struct padata_instance *pinst, int cpumask_type,
 			      cpumask_var_t cpumask);
 #else
 static inline void __init padata_init(void) {}
-static inline void __init padata_do_multithreaded(struct padata_mt_job *job)
+static inline void padata_do_multithreaded(struct padata_mt_job *job)
 {
 	job->thread_fn(job->start, job->start + job->size, job->fn_arg);
 }
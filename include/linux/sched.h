@@ -554,6 +554,7 @@ struct sched_statistics {
 	u64				nr_failed_migrations_affine;
 	u64				nr_failed_migrations_running;
 	u64				nr_failed_migrations_hot;
+	u64				nr_failed_migrations_cookie;
 	u64				nr_forced_migrations;
 
 	u64				nr_wakeups;
@@ -597,6 +598,9 @@ struct sched_entity {
 	/* 'Protected' deadline, to give out minimum quantums: */
 	u64				vprot;
 	u64				slice;
+	/* Run time between sleeps, for AUTO_SLICE: */
+	u64				burst_start;
+	u64				burst_avg;
 
 	u64				nr_migrations;
 
@@ -1366,6 +1366,23 @@ struct sk_buff *build_skb_around(struct sk_buff *skb,
 				 void *data, unsigned int frag_size);
 void skb_attempt_defer_free(struct sk_buff *skb);
 
+/* Remote frees staged for a single cpu, see skb_defer_batch_add() */
+#define SKB_DEFER_BATCH	16
+struct skb_defer_batch {
+	struct llist_node	*first;
+	struct llist_node	*last;
+	unsigned int		count;
+	int			cpu;
+};
+
+static inline void skb_defer_batch_init(struct skb_defer_batch *batch)
+{
+	batch->count = 0;
+}
+
+void skb_defer_batch_add(struct skb_defer_batch *batch, struct sk_buff *skb);
+void skb_defer_batch_flush(struct skb_defer_batch *batch);
+
 u32 napi_skb_cache_get_bulk(void **skbs, u32 n);
 struct sk_buff *napi_build_skb(void *data, unsigned int frag_size);
 struct sk_buff *slab_build_skb(void *data);
@@ -163,6 +163,8 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		VMA_LOCK_ABORT,
 		VMA_LOCK_RETRY,
 		VMA_LOCK_MISS,
+		MADVISE_VMA_LOCK_SUCCESS,
+		MADVISE_VMA_LOCK_FALLBACK,
 #endif
 #ifdef CONFIG_DEBUG_STACK_USAGE
 		KSTACK_1K,
@@ -182,6 +182,16 @@ struct workqueue_attrs {
 	 */
 	bool affn_strict;
 
+	/**
+	 * @affn_steal: let a backlog spill outside the affinity scope
+	 *
+	 * Only meaningful if @affn_strict is clear. If set, once a pool has
+	 * at least as many busy workers as there are CPUs in @__pod_cpumask,
+	 * further workers are woken up on idle CPUs of other pods in @cpumask
+	 * instead of being kept inside the pod.
+	 */
+	bool affn_steal;
+
 	/*
 	 * Below fields aren't properties of a worker_pool. They only modify how
 	 * :c:func:`apply_workqueue_attrs` select pools and thus don't
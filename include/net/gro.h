@@ -504,7 +504,7 @@ void __gro_flush(struct gro_node *gro, bool flush_old);
 
 static inline void gro_flush(struct gro_node *gro, bool flush_old)
 {
-	if (!gro->bitmask)
+	if (!(gro->bitmask | gro->rate_mask))
 		return;
 
 	__gro_flush(gro, flush_old);
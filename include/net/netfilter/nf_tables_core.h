@@ -92,6 +92,7 @@ extern const struct nft_set_type nft_set_rbtree_type;
 extern const struct nft_set_type nft_set_bitmap_type;
 extern const struct nft_set_type nft_set_pipapo_type;
 extern const struct nft_set_type nft_set_pipapo_avx2_type;
+extern const struct nft_set_type nft_set_pipapo_neon_type;
 
 #ifdef CONFIG_MITIGATION_RETPOLINE
 const struct nft_set_ext *
@@ -115,7 +116,7 @@ const struct nft_set_ext *
 nft_set_do_lookup(const struct net *net, const struct nft_set *set,
 		  const u32 *key);
 
-/* called from nft_pipapo_avx2.c */
+/* called from nft_pipapo_avx2.c and nft_set_pipapo_neon.c */
 const struct nft_set_ext *
 nft_pipapo_lookup(const struct net *net, const struct nft_set *set,
 		  const u32 *key);
@@ -123,6 +124,9 @@ nft_pipapo_lookup(const struct net *net, const struct nft_set *set,
 const struct nft_set_ext *
 nft_pipapo_avx2_lookup(const struct net *net, const struct nft_set *set,
 			const u32 *key);
+const struct nft_set_ext *
+nft_pipapo_neon_lookup(const struct net *net, const struct nft_set *set,
+		       const u32 *key);
 
 void nft_counter_init_seqcount(void);
 
@@ -3,6 +3,7 @@
 #ifndef _NET_PAGE_POOL_TYPES_H
 #define _NET_PAGE_POOL_TYPES_H
 
+#include <linux/cpumask_types.h>
 #include <linux/dma-direction.h>
 #include <linux/ptr_ring.h>
 #include <linux/types.h>
@@ -31,8 +32,16 @@
  */
 #define PP_FLAG_ALLOW_UNREADABLE_NETMEM BIT(3)
 
+/* Stage returns that cannot use the direct-recycle cache in a per-cpu sheaf
+ * and flush them into the ptr_ring in bulk. Useful when most frees happen
+ * away from the pool's NAPI context, e.g. with threaded NAPI or RPS.
+ */
+#define PP_FLAG_PERCPU_RECYCLE	BIT(4)
+
 #define PP_FLAG_ALL		(PP_FLAG_DMA_MAP | PP_FLAG_DMA_SYNC_DEV | \
-				 PP_FLAG_SYSTEM_POOL | PP_FLAG_ALLOW_UNREADABLE_NETMEM)
+				 PP_FLAG_SYSTEM_POOL | \
+				 PP_FLAG_ALLOW_UNREADABLE_NETMEM | \
+				 PP_FLAG_PERCPU_RECYCLE)
 
 /* Index limit to stay within PP_DMA_INDEX_BITS for DMA indices */
 #define PP_DMA_INDEX_LIMIT XA_LIMIT(1, BIT(PP_DMA_INDEX_BITS) - 1)
@@ -58,6 +67,23 @@ struct pp_alloc_cache {
 	netmem_ref cache[PP_ALLOC_CACHE_SIZE];
 };
 
+/*
+ * Per-cpu recycle sheaf, see PP_FLAG_PERCPU_RECYCLE
+ *
+ * Any context on a CPU may add to its sheaf. A full sheaf is flushed into
+ * the ptr_ring under a single producer lock acquisition, instead of taking
+ * the lock once per returned page. The lock is only contended when the
+ * pool's allocator finds the ptr_ring empty and pulls partially filled
+ * sheaves from other CPUs, so that pages are never stranded in a sheaf
+ * while the pool falls back to the page allocator.
+ */
+#define PP_RECYCLE_SHEAF_SIZE	32
+struct pp_recycle_sheaf {
+	spinlock_t lock;
+	u32 count;
+	netmem_ref netmems[PP_RECYCLE_SHEAF_SIZE];
+};
+
 /**
  * struct page_pool_params - page pool parameters
  * @fast:	params accessed frequently on hotpath
@@ -73,7 +99,7 @@ struct pp_alloc_cache {
  * @netdev:	netdev this pool will serve (leave as NULL if none or multiple)
  * @queue_idx:	queue idx this page_pool is being created for.
  * @flags:	PP_FLAG_DMA_MAP, PP_FLAG_DMA_SYNC_DEV, PP_FLAG_SYSTEM_POOL,
- *		PP_FLAG_ALLOW_UNREADABLE_NETMEM.
+ *		PP_FLAG_ALLOW_UNREADABLE_NETMEM, PP_FLAG_PERCPU_RECYCLE.
  */
 struct page_pool_params {
 	struct_group_tagged(page_pool_params_fast, fast,
@@ -123,6 +149,8 @@ struct page_pool_alloc_stats {
  * @ring:	page placed into the ptr ring
  * @ring_full:	page released from page pool because the ptr ring was full
  * @released_refcnt:	page released (and not recycled) because refcnt > 1
+ * @sheaf:	page placed into the per-cpu recycle sheaf
+ * @sheaf_flush:	per-cpu recycle sheaf flushed into the ptr ring
  */
 struct page_pool_recycle_stats {
 	u64 cached;
@@ -130,6 +158,8 @@ struct page_pool_recycle_stats {
 	u64 ring;
 	u64 ring_full;
 	u64 released_refcnt;
+	u64 sheaf;
+	u64 sheaf_flush;
 };
 
 /**
@@ -223,6 +253,13 @@ struct page_pool {
 	 */
 	struct ptr_ring ring;
 
+	/* Optional per-cpu staging in front of the ptr_ring, only
+	 * allocated with PP_FLAG_PERCPU_RECYCLE.
+	 */
+	struct pp_recycle_sheaf __percpu *sheaf;
+	cpumask_var_t sheaf_pending;	/* CPUs whose sheaf may be non-empty */
+	bool sheaf_disabled;
+
 	void *mp_priv;
 	const struct memory_provider_ops *mp_ops;
 
@@ -247,6 +247,33 @@ TRACE_EVENT(xdp_cpumap_enqueue,
 		  __entry->to_cpu)
 );
 
+TRACE_EVENT(xdp_cpumap_gro,
+
+	TP_PROTO(int map_id, unsigned int received, unsigned int merged),
+
+	TP_ARGS(map_id, received, merged),
+
+	TP_STRUCT__entry(
+		__field(int, map_id)
+		__field(int, cpu)
+		__field(unsigned int, received)
+		__field(unsigned int, merged)
+	),
+
+	TP_fast_assign(
+		__entry->map_id		= map_id;
+		__entry->cpu		= smp_processor_id();
+		__entry->received	= received;
+		__entry->merged		= merged;
+	),
+
+	TP_printk("gro"
+		  " cpu=%d map_id=%d"
+		  " received=%u merged=%u",
+		  __entry->cpu, __entry->map_id,
+		  __entry->received, __entry->merged)
+);
+
 TRACE_EVENT(xdp_devmap_xmit,
 
 	TP_PROTO(const struct net_device *from_dev,
@@ -94,8 +94,35 @@ struct epoll_params {
 	__u8 __pad;
 };
 
+struct epoll_ring_params {
+	__u32 entries;
+	__u32 flags;
+	__u64 __pad;
+};
+
+/*
+ * Ready ring set up with EPIOCSRING and mapped with mmap() on the epoll fd
+ * at offset 0. Readiness of edge-triggered items is published here by the
+ * kernel, which advances @tail. Userspace consumes entries and advances
+ * @head. Events that don't fit, and those of level-triggered items, are
+ * returned by epoll_wait() as usual. epoll_wait() returns 0 without
+ * sleeping while the ring isn't empty.
+ */
+struct epoll_ring {
+	__u32 head;
+	__u32 tail;
+	__u32 mask;
+	__u32 flags;
+	__u32 __resv[4];
+	struct epoll_event events[];
+};
+
+/* an event could not be published because the ring was full */
+#define EPOLL_RING_OVERFLOW	(1U << 0)
+
 #define EPOLL_IOC_TYPE 0x8A
 #define EPIOCSPARAMS _IOW(EPOLL_IOC_TYPE, 0x01, struct epoll_params)
 #define EPIOCGPARAMS _IOR(EPOLL_IOC_TYPE, 0x02, struct epoll_params)
+#define EPIOCSRING _IOWR(EPOLL_IOC_TYPE, 0x03, struct epoll_ring_params)
 
 #endif /* _UAPI_LINUX_EVENTPOLL_H */
@@ -240,6 +240,9 @@
  *  - add FUSE_COPY_FILE_RANGE_64
  *  - add struct fuse_copy_file_range_out
  *  - add FUSE_NOTIFY_PRUNE
+ *
+ *  7.46
+ *  - add FUSE_BACKING_ATTR flag for struct fuse_backing_map
  */
 
 #ifndef _LINUX_FUSE_H
@@ -275,7 +278,7 @@
 #define FUSE_KERNEL_VERSION 7
 
 /** Minor version number of this interface */
-#define FUSE_KERNEL_MINOR_VERSION 45
+#define FUSE_KERNEL_MINOR_VERSION 46
 
 /** The node ID of the root inode */
 #define FUSE_ROOT_ID 1
@@ -1126,6 +1129,15 @@ struct fuse_notify_prune_out {
 	uint64_t	spare;
 };
 
+/**
+ * fuse_backing_map flags
+ * FUSE_BACKING_ATTR: getattr on inodes in passthrough mode with this backing
+ *		      file may be answered from the backing inode, without a
+ *		      FUSE_GETATTR request.  The grant is suspended by
+ *		      FUSE_NOTIFY_INVAL_INODE until the next FUSE_GETATTR reply.
+ */
+#define FUSE_BACKING_ATTR	(1 << 0)
+
 struct fuse_backing_map {
 	int32_t		fd;
 	uint32_t	flags;
@@ -250,6 +250,14 @@ enum io_uring_sqe_flags_bit {
  */
 #define IORING_SETUP_SQ_REWIND		(1U << 20)
 
+/*
+ * Only meaningful with IORING_SETUP_SQPOLL. SQPOLL threads created with this
+ * flag by the same process form a group: a thread that is idle may submit
+ * pending SQEs on behalf of a busy thread on the same NUMA node. Rings using
+ * IORING_SETUP_IOPOLL or IORING_SETUP_SINGLE_ISSUER are never taken over.
+ */
+#define IORING_SETUP_SQPOLL_GROUP	(1U << 21)
+
 enum io_uring_op {
 	IORING_OP_NOP,
 	IORING_OP_READV,
@@ -766,6 +774,13 @@ struct io_uring_mem_region_reg {
  * -1 file descriptors.
  */
 #define IORING_RSRC_REGISTER_SPARSE	(1U << 0)
+/*
+ * Buffers only: @data points to an array of struct io_uring_reg_vec rather
+ * than struct iovec, and each entry registers one buffer made up of several
+ * user segments. Such a buffer is addressed by offset rather than by user
+ * address, where the segments are laid out back to back starting at 0.
+ */
+#define IORING_RSRC_REGISTER_VEC	(1U << 1)
 
 struct io_uring_rsrc_register {
 	__u32 nr;
@@ -775,6 +790,12 @@ struct io_uring_rsrc_register {
 	__aligned_u64 tags;
 };
 
+struct io_uring_reg_vec {
+	__aligned_u64 iovs;	/* struct iovec * */
+	__u32 nr_iovs;
+	__u32 resv;
+};
+
 struct io_uring_rsrc_update {
 	__u32 offset;
 	__u32 resv;
@@ -1059,7 +1080,8 @@ struct io_uring_zcrx_rqe {
 
 struct io_uring_zcrx_cqe {
 	__u64	off;
-	__u64	__pad;
+	__u32	napi_id;	/* napi the data arrived on, 0 if unknown */
+	__u32	__pad;
 };
 
 /* The bit from which area id is encoded into offsets */
@@ -1120,6 +1142,11 @@ struct io_uring_zcrx_ifq_reg {
 enum zcrx_ctrl_op {
 	ZCRX_CTRL_FLUSH_RQ,
 	ZCRX_CTRL_EXPORT,
+	/*
+	 * Bind another hw rx queue of the same netdev to the ifq. All queues
+	 * share the ifq's area and refill ring.
+	 */
+	ZCRX_CTRL_ADD_RXQ,
 
 	__ZCRX_CTRL_LAST,
 };
@@ -1133,6 +1160,11 @@ struct zcrx_ctrl_export {
 	__u32 		__resv1[11];
 };
 
+struct zcrx_ctrl_add_rxq {
+	__u32		if_rxq;
+	__u32		__resv1[11];
+};
+
 struct zcrx_ctrl {
 	__u32	zcrx_id;
 	__u32	op; /* see enum zcrx_ctrl_op */
@@ -1141,6 +1173,7 @@ struct zcrx_ctrl {
 	union {
 		struct zcrx_ctrl_export		zc_export;
 		struct zcrx_ctrl_flush_rq	zc_flush;
+		struct zcrx_ctrl_add_rxq	zc_add_rxq;
 	};
 };
 
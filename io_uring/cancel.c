@@ -619,6 +619,15 @@ __cold void io_uring_cancel_generic(bool cancel_all, struct io_sq_data *sqd)
 								     current->io_uring,
 								     cancel_all,
 								     true);
+			/* requests submitted on rings of other group members */
+			xa_for_each(&tctx->xa, index, node) {
+				if (node->ctx->sq_data == sqd)
+					continue;
+				loop |= io_uring_try_cancel_requests(node->ctx,
+							current->io_uring,
+							cancel_all,
+							false);
+			}
 		}
 
 		if (loop) {
@@ -69,7 +69,8 @@ static void __io_uring_show_fdinfo(struct io_ring_ctx *ctx, struct seq_file *m)
 	unsigned int sq_shift = 0;
 	unsigned int cq_entries, sq_entries;
 	int sq_pid = -1, sq_cpu = -1;
-	u64 sq_total_time = 0, sq_work_time = 0;
+	u64 sq_total_time = 0, sq_work_time = 0, sq_stolen = 0;
+	bool sq_group = false;
 	unsigned int i;
 
 	if (ctx->flags & IORING_SETUP_SQE128)
@@ -195,6 +196,8 @@ static void __io_uring_show_fdinfo(struct io_ring_ctx *ctx, struct seq_file *m)
 			sq_cpu = sq->sq_cpu;
 			sq_total_time = usec;
 			sq_work_time = sq->work_time;
+			sq_group = sq->group;
+			sq_stolen = READ_ONCE(sq->nr_stolen);
 		} else {
 			rcu_read_unlock();
 		}
@@ -204,6 +207,8 @@ static void __io_uring_show_fdinfo(struct io_ring_ctx *ctx, struct seq_file *m)
 	seq_printf(m, "SqThreadCpu:\t%d\n", sq_cpu);
 	seq_printf(m, "SqTotalTime:\t%llu\n", sq_total_time);
 	seq_printf(m, "SqWorkTime:\t%llu\n", sq_work_time);
+	if (sq_group)
+		seq_printf(m, "SqStolen:\t%llu\n", sq_stolen);
 	seq_printf(m, "UserFiles:\t%u\n", ctx->file_table.data.nr);
 	for (i = 0; i < ctx->file_table.data.nr; i++) {
 		struct file *f = NULL;
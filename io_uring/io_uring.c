@@ -2776,6 +2776,8 @@ static int io_uring_sanitise_params(struct io_uring_params *p)
 			     IORING_SETUP_TASKRUN_FLAG |
 			     IORING_SETUP_DEFER_TASKRUN))
 			return -EINVAL;
+	} else if (flags & IORING_SETUP_SQPOLL_GROUP) {
+		return -EINVAL;
 	}
 
 	if (flags & IORING_SETUP_TASKRUN_FLAG) {
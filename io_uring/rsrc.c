@@ -29,6 +29,9 @@ struct io_rsrc_update {
 
 static struct io_rsrc_node *io_sqe_buffer_register(struct io_ring_ctx *ctx,
 			struct iovec *iov, struct page **last_hpage);
+static int io_sqe_buffers_register_vec(struct io_ring_ctx *ctx,
+			void __user *arg, unsigned int nr_args,
+			u64 __user *tags);
 
 /* only define max */
 #define IORING_MAX_FIXED_FILES	(1U << 20)
@@ -390,18 +393,27 @@ __cold int io_register_rsrc(struct io_ring_ctx *ctx, void __user *arg,
 		return -EFAULT;
 	if (!rr.nr || rr.resv2)
 		return -EINVAL;
-	if (rr.flags & ~IORING_RSRC_REGISTER_SPARSE)
+	if (rr.flags & ~(IORING_RSRC_REGISTER_SPARSE | IORING_RSRC_REGISTER_VEC))
 		return -EINVAL;
 
 	switch (type) {
 	case IORING_RSRC_FILE:
 		if (rr.flags & IORING_RSRC_REGISTER_SPARSE && rr.data)
 			break;
+		if (rr.flags & IORING_RSRC_REGISTER_VEC)
+			break;
 		return io_sqe_files_register(ctx, u64_to_user_ptr(rr.data),
 					     rr.nr, u64_to_user_ptr(rr.tags));
 	case IORING_RSRC_BUFFER:
 		if (rr.flags & IORING_RSRC_REGISTER_SPARSE && rr.data)
 			break;
+		if (rr.flags & IORING_RSRC_REGISTER_VEC) {
+			if (!rr.data)
+				break;
+			return io_sqe_buffers_register_vec(ctx,
+					u64_to_user_ptr(rr.data), rr.nr,
+					u64_to_user_ptr(rr.tags));
+		}
 		return io_sqe_buffers_register(ctx, u64_to_user_ptr(rr.data),
 					       rr.nr, u64_to_user_ptr(rr.tags));
 	}
@@ -855,6 +867,163 @@ static struct io_rsrc_node *io_sqe_buffer_register(struct io_ring_ctx *ctx,
 	return node;
 }
 
+/*
+ * Register one buffer out of several user segments. Everything is pinned and
+ * the bvec table built here, so that requests using it pay no per-segment
+ * cost beyond the lookup. Segments are not coalesced into folios, as the
+ * table is walked rather than indexed when importing.
+ */
+static struct io_rsrc_node *io_sqe_buffer_register_vec(struct io_ring_ctx *ctx,
+						       struct iovec *iovs,
+						       unsigned int nr_iovs,
+						       struct page **last_hpage)
+{
+	struct io_mapped_ubuf *imu = NULL;
+	struct page **pages = NULL;
+	struct io_rsrc_node *node;
+	unsigned long total_pages = 0;
+	size_t total_len = 0;
+	int ret, nr_pages = 0, i, j;
+
+	for (i = 0; i < nr_iovs; i++) {
+		ret = io_validate_user_buf_range((unsigned long)iovs[i].iov_base,
+						 iovs[i].iov_len);
+		if (ret)
+			return ERR_PTR(ret);
+		total_len += iovs[i].iov_len;
+		total_pages += PAGE_ALIGN(offset_in_page(iovs[i].iov_base) +
+					  iovs[i].iov_len) >> PAGE_SHIFT;
+	}
+	if (total_len > SZ_1G)
+		return ERR_PTR(-EFAULT);
+
+	node = io_rsrc_node_alloc(ctx, IORING_RSRC_BUFFER);
+	if (!node)
+		return ERR_PTR(-ENOMEM);
+
+	ret = -ENOMEM;
+	pages = kvmalloc_objs(struct page *, total_pages, GFP_KERNEL_ACCOUNT);
+	if (!pages)
+		goto done;
+	imu = io_alloc_imu(ctx, total_pages);
+	if (!imu)
+		goto done;
+	imu->nr_bvecs = total_pages;
+
+	for (i = 0; i < nr_iovs; i++) {
+		unsigned long off = offset_in_page(iovs[i].iov_base);
+		size_t size = iovs[i].iov_len;
+		struct page **seg_pages;
+		int seg_nr;
+
+		seg_pages = io_pin_pages((unsigned long)iovs[i].iov_base, size,
+					 &seg_nr);
+		if (IS_ERR(seg_pages)) {
+			ret = PTR_ERR(seg_pages);
+			goto done;
+		}
+		for (j = 0; j < seg_nr; j++) {
+			size_t vec_len = min_t(size_t, size, PAGE_SIZE - off);
+
+			pages[nr_pages] = seg_pages[j];
+			bvec_set_page(&imu->bvec[nr_pages], seg_pages[j],
+				      vec_len, off);
+			nr_pages++;
+			off = 0;
+			size -= vec_len;
+		}
+		kvfree(seg_pages);
+	}
+
+	ret = io_buffer_account_pin(ctx, pages, nr_pages, imu, last_hpage);
+	if (ret)
+		goto done;
+
+	imu->ubuf = 0;
+	imu->len = total_len;
+	imu->folio_shift = PAGE_SHIFT;
+	imu->release = io_release_ubuf;
+	imu->priv = imu;
+	imu->flags = IO_REGBUF_F_VEC;
+	imu->dir = IO_IMU_DEST | IO_IMU_SOURCE;
+	refcount_set(&imu->refs, 1);
+	node->buf = imu;
+done:
+	if (ret) {
+		for (i = 0; i < nr_pages; i++)
+			unpin_user_folio(page_folio(pages[i]), 1);
+		if (imu)
+			io_free_imu(ctx, imu);
+		io_cache_free(&ctx->node_cache, node);
+		node = ERR_PTR(ret);
+	}
+	kvfree(pages);
+	return node;
+}
+
+static int io_sqe_buffers_register_vec(struct io_ring_ctx *ctx,
+				       void __user *arg, unsigned int nr_args,
+				       u64 __user *tags)
+{
+	struct io_uring_reg_vec __user *uvecs = arg;
+	struct iovec fast_iov[UIO_FASTIOV];
+	struct page *last_hpage = NULL;
+	struct io_rsrc_data data;
+	int i, ret;
+
+	if (ctx->buf_table.nr)
+		return -EBUSY;
+	if (!nr_args || nr_args > IORING_MAX_REG_BUFFERS)
+		return -EINVAL;
+	ret = io_rsrc_data_alloc(&data, nr_args);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nr_args; i++) {
+		struct io_uring_reg_vec rv;
+		struct io_rsrc_node *node;
+		struct iovec *iov;
+		u64 tag = 0;
+
+		if (copy_from_user(&rv, &uvecs[i], sizeof(rv))) {
+			ret = -EFAULT;
+			break;
+		}
+		if (rv.resv || !rv.nr_iovs || rv.nr_iovs > UIO_MAXIOV) {
+			ret = -EINVAL;
+			break;
+		}
+		if (tags && copy_from_user(&tag, &tags[i], sizeof(tag))) {
+			ret = -EFAULT;
+			break;
+		}
+
+		iov = iovec_from_user(u64_to_user_ptr(rv.iovs), rv.nr_iovs,
+				      UIO_FASTIOV, fast_iov, ctx->compat);
+		if (IS_ERR(iov)) {
+			ret = PTR_ERR(iov);
+			break;
+		}
+		node = io_sqe_buffer_register_vec(ctx, iov, rv.nr_iovs,
+						  &last_hpage);
+		if (iov != fast_iov)
+			kfree(iov);
+		if (IS_ERR(node)) {
+			ret = PTR_ERR(node);
+			break;
+		}
+		node->tag = tag;
+		data.nodes[i] = node;
+	}
+
+	ctx->buf_table = data;
+	if (ret) {
+		io_clear_table_tags(&ctx->buf_table);
+		io_sqe_buffers_unregister(ctx);
+	}
+	return ret;
+}
+
 int io_sqe_buffers_register(struct io_ring_ctx *ctx, void __user *arg,
 			    unsigned int nr_args, u64 __user *tags)
 {
@@ -1064,7 +1233,7 @@ static int io_import_fixed(int ddir, struct iov_iter *iter,
 
 	offset = buf_addr - imu->ubuf;
 
-	if (imu->flags & IO_REGBUF_F_KBUF)
+	if (imu->flags & IO_REGBUF_F_OFFSET)
 		return io_import_kbuf(ddir, iter, imu, len, offset);
 
 	/*
@@ -1484,7 +1653,7 @@ int io_import_reg_vec(int ddir, struct iov_iter *iter,
 	iovec_off = vec->nr - nr_iovs;
 	iov = vec->iovec + iovec_off;
 
-	if (imu->flags & IO_REGBUF_F_KBUF) {
+	if (imu->flags & IO_REGBUF_F_OFFSET) {
 		int ret = io_kern_bvec_size(iov, nr_iovs, imu, &nr_segs);
 
 		if (unlikely(ret))
@@ -1522,7 +1691,7 @@ int io_import_reg_vec(int ddir, struct iov_iter *iter,
 		req->flags |= REQ_F_NEED_CLEANUP;
 	}
 
-	if (imu->flags & IO_REGBUF_F_KBUF)
+	if (imu->flags & IO_REGBUF_F_OFFSET)
 		return io_vec_fill_kern_bvec(ddir, iter, imu, iov, nr_iovs, vec);
 
 	return io_vec_fill_bvec(ddir, iter, imu, iov, nr_iovs, vec);
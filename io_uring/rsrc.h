@@ -30,8 +30,13 @@ enum {
 
 enum {
 	IO_REGBUF_F_KBUF		= 1,
+	/* user segments laid out back to back, addressed from offset 0 */
+	IO_REGBUF_F_VEC			= 2,
 };
 
+/* buffers with no user address, imported by offset into the bvec table */
+#define IO_REGBUF_F_OFFSET	(IO_REGBUF_F_KBUF | IO_REGBUF_F_VEC)
+
 struct io_mapped_ubuf {
 	u64		ubuf;
 	unsigned int	len;
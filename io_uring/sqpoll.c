@@ -30,6 +30,10 @@ enum {
 	IO_SQ_THREAD_SHOULD_PARK,
 };
 
+/* running SQPOLL threads created with IORING_SETUP_SQPOLL_GROUP */
+static LIST_HEAD(io_sq_group_list);
+static DEFINE_SPINLOCK(io_sq_group_lock);
+
 void io_sq_thread_unpark(struct io_sq_data *sqd)
 	__releases(&sqd->lock)
 {
@@ -160,6 +164,7 @@ static struct io_sq_data *io_get_sq_data(struct io_uring_params *p,
 	atomic_set(&sqd->park_pending, 0);
 	refcount_set(&sqd->refs, 1);
 	INIT_LIST_HEAD(&sqd->ctx_list);
+	INIT_LIST_HEAD(&sqd->group_node);
 	mutex_init(&sqd->lock);
 	init_waitqueue_head(&sqd->wait);
 	init_completion(&sqd->exited);
@@ -242,6 +247,105 @@ static int __io_sq_thread(struct io_ring_ctx *ctx, struct io_sq_data *sqd,
 	return ret;
 }
 
+/*
+ * Drop the ring we offered to the group, if nobody took it yet. Must be done
+ * before the thread blocks, a dying ring waits for its refs to go away.
+ */
+static void io_sq_retract(struct io_sq_data *sqd)
+{
+	struct io_ring_ctx *ctx;
+
+	if (!READ_ONCE(sqd->steal_ctx))
+		return;
+	ctx = xchg(&sqd->steal_ctx, NULL);
+	if (ctx)
+		percpu_ref_put(&ctx->refs);
+}
+
+/*
+ * If one of our rings still has more than a batch of SQEs pending after a
+ * full pass, offer it to an idle thread of the group.
+ */
+static void io_sq_offer(struct io_sq_data *sqd)
+{
+	struct io_ring_ctx *ctx;
+
+	if (!sqd->group || READ_ONCE(sqd->steal_ctx))
+		return;
+
+	list_for_each_entry(ctx, &sqd->ctx_list, sqd_list) {
+		/* iopoll completions must be reaped by whoever issued them */
+		if (ctx->flags & (IORING_SETUP_IOPOLL | IORING_SETUP_SINGLE_ISSUER))
+			continue;
+		if (io_sqring_entries(ctx) <= IORING_SQPOLL_CAP_ENTRIES_VALUE)
+			continue;
+		if (!percpu_ref_tryget_live(&ctx->refs))
+			continue;
+		if (cmpxchg(&sqd->steal_ctx, NULL, ctx))
+			percpu_ref_put(&ctx->refs);
+		return;
+	}
+}
+
+/*
+ * Take over a ring offered by another thread of our group on the same node
+ * and submit a batch from it. Completions of these requests are run from
+ * our task_work, as for our own rings.
+ */
+static bool io_sq_steal(struct io_sq_data *sqd, struct io_sq_time *ist)
+{
+	struct io_ring_ctx *ctx = NULL;
+	struct io_sq_data *victim;
+	int node = cpu_to_node(sqd->sq_cpu);
+	int ret;
+
+	if (!sqd->group || list_empty_careful(&io_sq_group_list))
+		return false;
+
+	spin_lock(&io_sq_group_lock);
+	list_for_each_entry(victim, &io_sq_group_list, group_node) {
+		if (victim == sqd || victim->task_tgid != sqd->task_tgid)
+			continue;
+		if (!READ_ONCE(victim->steal_ctx) ||
+		    cpu_to_node(READ_ONCE(victim->sq_cpu)) != node)
+			continue;
+		ctx = xchg(&victim->steal_ctx, NULL);
+		if (ctx)
+			break;
+	}
+	spin_unlock(&io_sq_group_lock);
+	if (!ctx)
+		return false;
+
+	ret = __io_uring_add_tctx_node(ctx);
+	if (!ret) {
+		ret = __io_sq_thread(ctx, sqd, true, ist);
+		if (ret > 0)
+			sqd->nr_stolen += ret;
+	}
+	percpu_ref_put(&ctx->refs);
+	return ret > 0;
+}
+
+static void io_sq_group_join(struct io_sq_data *sqd)
+{
+	if (!sqd->group)
+		return;
+	spin_lock(&io_sq_group_lock);
+	list_add_tail(&sqd->group_node, &io_sq_group_list);
+	spin_unlock(&io_sq_group_lock);
+}
+
+static void io_sq_group_leave(struct io_sq_data *sqd)
+{
+	if (!sqd->group)
+		return;
+	spin_lock(&io_sq_group_lock);
+	list_del_init(&sqd->group_node);
+	spin_unlock(&io_sq_group_lock);
+	io_sq_retract(sqd);
+}
+
 static bool io_sqd_handle_event(struct io_sq_data *sqd)
 {
 	bool did_sig = false;
@@ -320,6 +424,7 @@ static int io_sq_thread(void *data)
 		set_cpus_allowed_ptr(current, cpu_online_mask);
 		sqd->sq_cpu = raw_smp_processor_id();
 	}
+	io_sq_group_join(sqd);
 
 	/*
 	 * Force audit context to get setup, in case we do prep side async
@@ -335,6 +440,7 @@ static int io_sq_thread(void *data)
 		struct io_sq_time ist = { };
 
 		if (io_sqd_events_pending(sqd) || signal_pending(current)) {
+			io_sq_retract(sqd);
 			if (io_sqd_handle_event(sqd))
 				break;
 			timeout = jiffies + sqd->sq_thread_idle;
@@ -350,6 +456,11 @@ static int io_sq_thread(void *data)
 		if (io_sq_tw(&retry_list, IORING_TW_CAP_ENTRIES_VALUE))
 			sqt_spin = true;
 
+		if (sqt_spin)
+			io_sq_offer(sqd);
+		else if (io_sq_steal(sqd, &ist))
+			sqt_spin = true;
+
 		list_for_each_entry(ctx, &sqd->ctx_list, sqd_list) {
 			if (io_napi(ctx)) {
 				io_sq_start_worktime(&ist);
@@ -397,6 +508,7 @@ static int io_sq_thread(void *data)
 			}
 
 			if (needs_sched) {
+				io_sq_retract(sqd);
 				mutex_unlock(&sqd->lock);
 				schedule();
 				mutex_lock(&sqd->lock);
@@ -411,6 +523,7 @@ static int io_sq_thread(void *data)
 		timeout = jiffies + sqd->sq_thread_idle;
 	}
 
+	io_sq_group_leave(sqd);
 	if (retry_list)
 		io_sq_tw(&retry_list, UINT_MAX);
 
@@ -514,6 +627,7 @@ __cold int io_sq_offload_create(struct io_ring_ctx *ctx,
 
 		sqd->task_pid = current->pid;
 		sqd->task_tgid = current->tgid;
+		sqd->group = !!(p->flags & IORING_SETUP_SQPOLL_GROUP);
 		tsk = create_io_thread(io_sq_thread, sqd, NUMA_NO_NODE);
 		if (IS_ERR(tsk)) {
 			ret = PTR_ERR(tsk);
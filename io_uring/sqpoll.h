@@ -19,6 +19,14 @@ struct io_sq_data {
 	u64			work_time;
 	unsigned long		state;
 	struct completion	exited;
+
+	/* IORING_SETUP_SQPOLL_GROUP */
+	bool			group;
+	struct list_head	group_node;
+	/* ring offered to idle group members, holds a ctx->refs reference */
+	struct io_ring_ctx	*steal_ctx;
+	/* sqes this thread submitted on rings owned by other group members */
+	u64			nr_stolen;
 };
 
 int io_sq_offload_create(struct io_ring_ctx *ctx, struct io_uring_params *p);
@@ -518,7 +518,6 @@ static struct io_zcrx_ifq *io_zcrx_ifq_alloc(struct io_ring_ctx *ctx)
 	if (!ifq)
 		return NULL;
 
-	ifq->if_rxq = -1;
 	spin_lock_init(&ifq->rq_lock);
 	mutex_init(&ifq->pp_lock);
 	refcount_set(&ifq->refs, 1);
@@ -544,19 +543,118 @@ static void io_close_queue(struct io_zcrx_ifq *ifq)
 		.mp_ops = &io_uring_pp_zc_ops,
 		.mp_priv = ifq,
 	};
+	u32 rxqs[IO_ZCRX_MAX_RXQS];
+	unsigned i, nr_rxqs;
 
+	/*
+	 * Take over the netdev reference, but leave the queues registered.
+	 * Each one is removed by its own ->uninstall, and only the last one
+	 * unmaps the area, when no queue can DMA into it anymore.
+	 */
 	scoped_guard(mutex, &ifq->pp_lock) {
 		netdev = ifq->netdev;
 		netdev_tracker = ifq->netdev_tracker;
 		ifq->netdev = NULL;
+		nr_rxqs = ifq->nr_rxqs;
+		memcpy(rxqs, ifq->if_rxqs, nr_rxqs * sizeof(rxqs[0]));
 	}
 
 	if (netdev) {
-		if (ifq->if_rxq != -1)
-			net_mp_close_rxq(netdev, ifq->if_rxq, &p);
+		for (i = 0; i < nr_rxqs; i++)
+			net_mp_close_rxq(netdev, rxqs[i], &p);
 		netdev_put(netdev, &netdev_tracker);
 	}
-	ifq->if_rxq = -1;
+}
+
+/* Returns the number of queues still bound to the ifq. */
+static unsigned io_zcrx_del_rxq(struct io_zcrx_ifq *ifq, u32 rxq_idx)
+{
+	unsigned i;
+
+	lockdep_assert_held(&ifq->pp_lock);
+
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		if (ifq->if_rxqs[i] != rxq_idx)
+			continue;
+		ifq->if_rxqs[i] = ifq->if_rxqs[--ifq->nr_rxqs];
+		break;
+	}
+	return ifq->nr_rxqs;
+}
+
+static int zcrx_check_add_rxq(struct io_zcrx_ifq *ifq,
+			      struct net_device *netdev, u32 rxq_idx)
+{
+	unsigned i;
+
+	lockdep_assert_held(&ifq->pp_lock);
+
+	if (ifq->netdev != netdev)
+		return -ENODEV;
+	if (ifq->nr_rxqs >= IO_ZCRX_MAX_RXQS)
+		return -ENOSPC;
+	for (i = 0; i < ifq->nr_rxqs; i++)
+		if (ifq->if_rxqs[i] == rxq_idx)
+			return -EEXIST;
+	return 0;
+}
+
+static int zcrx_add_rxq(struct io_zcrx_ifq *ifq, struct zcrx_ctrl *ctrl)
+{
+	struct zcrx_ctrl_add_rxq *ca = &ctrl->zc_add_rxq;
+	struct pp_memory_provider_params mp_param = {
+		.mp_ops = &io_uring_pp_zc_ops,
+		.mp_priv = ifq,
+		.rx_page_size = ifq->rx_page_size,
+	};
+	netdevice_tracker netdev_tracker;
+	struct net_device *netdev;
+	int ret;
+
+	if (!capable(CAP_NET_ADMIN))
+		return -EPERM;
+	if (!mem_is_zero(&ca->__resv1, sizeof(ca->__resv1)))
+		return -EINVAL;
+
+	scoped_guard(mutex, &ifq->pp_lock) {
+		netdev = ifq->netdev;
+		if (!netdev)
+			return -ENODEV;
+		netdev_hold(netdev, &netdev_tracker, GFP_KERNEL);
+	}
+
+	/*
+	 * Install and register the queue under the instance lock, which
+	 * io_close_queue() needs to close any queue. The area thus stays
+	 * mapped for as long as the new queue is installed.
+	 */
+	netdev_lock(netdev);
+	scoped_guard(mutex, &ifq->pp_lock)
+		ret = zcrx_check_add_rxq(ifq, netdev, ca->if_rxq);
+	if (ret)
+		goto out_unlock;
+
+	/* the area is mapped once, for the device of the first queue */
+	if (netdev_queue_get_dma_dev(netdev, ca->if_rxq) != ifq->dev) {
+		ret = -EOPNOTSUPP;
+		goto out_unlock;
+	}
+	ret = __net_mp_open_rxq(netdev, ca->if_rxq, &mp_param, NULL);
+	if (ret)
+		goto out_unlock;
+
+	scoped_guard(mutex, &ifq->pp_lock) {
+		ret = zcrx_check_add_rxq(ifq, netdev, ca->if_rxq);
+		if (!ret)
+			ifq->if_rxqs[ifq->nr_rxqs++] = ca->if_rxq;
+	}
+	/* raced with io_close_queue(), undo */
+	if (ret)
+		__net_mp_close_rxq(netdev, ca->if_rxq, &mp_param);
+out_unlock:
+	netdev_unlock(netdev);
+	netdev_put(netdev, &netdev_tracker);
+	return ret;
 }
 
 static void io_zcrx_ifq_free(struct io_zcrx_ifq *ifq)
@@ -838,14 +936,18 @@ int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 		goto netdev_put_unlock;
 
 	if (reg.rx_buf_len)
-		mp_param.rx_page_size = 1U << ifq->niov_shift;
+		ifq->rx_page_size = 1U << ifq->niov_shift;
+	mp_param.rx_page_size = ifq->rx_page_size;
 	mp_param.mp_ops = &io_uring_pp_zc_ops;
 	mp_param.mp_priv = ifq;
 	ret = __net_mp_open_rxq(ifq->netdev, reg.if_rxq, &mp_param, NULL);
 	if (ret)
 		goto netdev_put_unlock;
 	netdev_unlock(ifq->netdev);
-	ifq->if_rxq = reg.if_rxq;
+	scoped_guard(mutex, &ifq->pp_lock) {
+		ifq->if_rxqs[0] = reg.if_rxq;
+		ifq->nr_rxqs = 1;
+	}
 
 	reg.zcrx_id = id;
 
@@ -1081,10 +1183,17 @@ static void io_pp_uninstall(void *mp_priv, struct netdev_rx_queue *rxq)
 {
 	struct pp_memory_provider_params *p = &rxq->mp_params;
 	struct io_zcrx_ifq *ifq = mp_priv;
+	unsigned left;
 
-	io_zcrx_drop_netdev(ifq);
-	if (ifq->area)
-		io_zcrx_unmap_area(ifq, ifq->area);
+	scoped_guard(mutex, &ifq->pp_lock)
+		left = io_zcrx_del_rxq(ifq, get_netdev_rx_queue_index(rxq));
+
+	/* the area and netdev are shared by all queues of the ifq */
+	if (!left) {
+		io_zcrx_drop_netdev(ifq);
+		if (ifq->area)
+			io_zcrx_unmap_area(ifq, ifq->area);
+	}
 
 	p->mp_ops = NULL;
 	p->mp_priv = NULL;
@@ -1185,13 +1294,16 @@ int io_zcrx_ctrl(struct io_ring_ctx *ctx, void __user *arg, unsigned nr_args)
 		return zcrx_flush_rq(ctx, zcrx, &ctrl);
 	case ZCRX_CTRL_EXPORT:
 		return zcrx_export(ctx, zcrx, &ctrl, arg);
+	case ZCRX_CTRL_ADD_RXQ:
+		return zcrx_add_rxq(zcrx, &ctrl);
 	}
 
 	return -EOPNOTSUPP;
 }
 
 static bool io_zcrx_queue_cqe(struct io_kiocb *req, struct net_iov *niov,
-			      struct io_zcrx_ifq *ifq, int off, int len)
+			      struct io_zcrx_ifq *ifq, int off, int len,
+			      unsigned int napi_id)
 {
 	struct io_ring_ctx *ctx = req->ctx;
 	struct io_uring_zcrx_cqe *rcqe;
@@ -1212,6 +1324,8 @@ static bool io_zcrx_queue_cqe(struct io_kiocb *req, struct net_iov *niov,
 	offset = off + (net_iov_idx(niov) << ifq->niov_shift);
 	rcqe = (struct io_uring_zcrx_cqe *)(cqe + 1);
 	rcqe->off = offset + ((u64)area->area_id << IORING_ZCRX_AREA_SHIFT);
+	/* lets the user tell the queues of a multi-queue ifq apart */
+	rcqe->napi_id = napi_id;
 	rcqe->__pad = 0;
 	return true;
 }
@@ -1282,7 +1396,7 @@ static ssize_t io_copy_page(struct io_copy_cache *cc, struct page *src_page,
 
 static ssize_t io_zcrx_copy_chunk(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 				  struct page *src_page, unsigned int src_offset,
-				  size_t len)
+				  size_t len, unsigned int napi_id)
 {
 	size_t copied = 0;
 	int ret = 0;
@@ -1304,7 +1418,7 @@ static ssize_t io_zcrx_copy_chunk(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 
 		n = io_copy_page(&cc, src_page, src_offset, len);
 
-		if (!io_zcrx_queue_cqe(req, niov, ifq, 0, n)) {
+		if (!io_zcrx_queue_cqe(req, niov, ifq, 0, n, napi_id)) {
 			io_zcrx_return_niov(niov);
 			ret = -ENOSPC;
 			break;
@@ -1320,21 +1434,24 @@ static ssize_t io_zcrx_copy_chunk(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 }
 
 static int io_zcrx_copy_frag(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
-			     const skb_frag_t *frag, int off, int len)
+			     const skb_frag_t *frag, int off, int len,
+			     unsigned int napi_id)
 {
 	struct page *page = skb_frag_page(frag);
 
-	return io_zcrx_copy_chunk(req, ifq, page, off + skb_frag_off(frag), len);
+	return io_zcrx_copy_chunk(req, ifq, page, off + skb_frag_off(frag), len,
+				  napi_id);
 }
 
 static int io_zcrx_recv_frag(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
-			     const skb_frag_t *frag, int off, int len)
+			     const skb_frag_t *frag, int off, int len,
+			     unsigned int napi_id)
 {
 	struct net_iov *niov;
 	struct page_pool *pp;
 
 	if (unlikely(!skb_frag_is_net_iov(frag)))
-		return io_zcrx_copy_frag(req, ifq, frag, off, len);
+		return io_zcrx_copy_frag(req, ifq, frag, off, len, napi_id);
 
 	niov = netmem_to_net_iov(frag->netmem);
 	pp = niov->desc.pp;
@@ -1342,7 +1459,8 @@ static int io_zcrx_recv_frag(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 	if (!pp || pp->mp_ops != &io_uring_pp_zc_ops || io_pp_to_ifq(pp) != ifq)
 		return -EFAULT;
 
-	if (!io_zcrx_queue_cqe(req, niov, ifq, off + skb_frag_off(frag), len))
+	if (!io_zcrx_queue_cqe(req, niov, ifq, off + skb_frag_off(frag), len,
+			       napi_id))
 		return -ENOSPC;
 
 	/*
@@ -1385,7 +1503,7 @@ io_zcrx_recv_skb(read_descriptor_t *desc, struct sk_buff *skb,
 		to_copy = min_t(size_t, skb_headlen(skb) - offset, len);
 		copied = io_zcrx_copy_chunk(req, ifq, virt_to_page(skb->data),
 					    offset_in_page(skb->data) + offset,
-					    to_copy);
+					    to_copy, skb_napi_id(skb));
 		if (copied < 0) {
 			ret = copied;
 			goto out;
@@ -1415,7 +1533,8 @@ io_zcrx_recv_skb(read_descriptor_t *desc, struct sk_buff *skb,
 				copy = len;
 
 			off = offset - start;
-			ret = io_zcrx_recv_frag(req, ifq, frag, off, copy);
+			ret = io_zcrx_recv_frag(req, ifq, frag, off, copy,
+						skb_napi_id(skb));
 			if (ret < 0)
 				goto out;
 
@@ -38,6 +38,9 @@ struct io_zcrx_area {
 	struct io_zcrx_mem	mem;
 };
 
+/* max hw rx queues a single ifq can be bound to */
+#define IO_ZCRX_MAX_RXQS		64
+
 struct io_zcrx_ifq {
 	struct io_zcrx_area		*area;
 	unsigned			niov_shift;
@@ -50,7 +53,10 @@ struct io_zcrx_ifq {
 	u32				cached_rq_head;
 	u32				rq_entries;
 
-	u32				if_rxq;
+	/* bound hw rx queues, protected by pp_lock */
+	u32				if_rxqs[IO_ZCRX_MAX_RXQS];
+	unsigned			nr_rxqs;
+	u32				rx_page_size;
 	struct device			*dev;
 	struct net_device		*netdev;
 	netdevice_tracker		netdev_tracker;
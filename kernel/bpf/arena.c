@@ -390,7 +390,7 @@ static vm_fault_t arena_vm_fault(struct vm_fault *vmf)
 
 	struct apply_range_data data = { .pages = &page, .i = 0 };
 	/* Account into memcg of the process that created bpf_arena */
-	ret = bpf_map_alloc_pages(map, NUMA_NO_NODE, 1, &page);
+	ret = bpf_map_alloc_pages(map, map->numa_node, 1, &page);
 	if (ret) {
 		range_tree_set(&arena->rt, vmf->pgoff, 1);
 		goto out_unlock_sigsegv;
@@ -561,6 +561,10 @@ static long arena_alloc_pages(struct bpf_arena *arena, long uaddr, long page_cnt
 			return 0;
 	}
 
+	/* Without an explicit node, honour the node the arena was created on */
+	if (node_id == NUMA_NO_NODE)
+		node_id = arena->map.numa_node;
+
 	bpf_map_memcg_enter(&arena->map, &old_memcg, &new_memcg);
 	/* Cap allocation size to KMALLOC_MAX_CACHE_SIZE so kmalloc_nolock() can succeed. */
 	alloc_pages = min(page_cnt, KMALLOC_MAX_CACHE_SIZE / sizeof(struct page *));
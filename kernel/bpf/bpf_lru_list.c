@@ -41,6 +41,11 @@ static void bpf_lru_node_clear_ref(struct bpf_lru_node *node)
 	WRITE_ONCE(node->ref, 0);
 }
 
+static void bpf_lru_count_evicted(struct bpf_lru *lru)
+{
+	this_cpu_inc(*lru->nr_evicted);
+}
+
 static void bpf_lru_list_count_inc(struct bpf_lru_list *l,
 				   enum bpf_lru_list_type type)
 {
@@ -215,6 +220,7 @@ __bpf_lru_list_shrink_inactive(struct bpf_lru *lru,
 		if (bpf_lru_node_is_ref(node)) {
 			__bpf_lru_node_move(l, node, BPF_LRU_LIST_T_ACTIVE);
 		} else if (lru->del_from_htab(lru->del_arg, node)) {
+			bpf_lru_count_evicted(lru);
 			__bpf_lru_node_move_to_free(l, node, free_list,
 						    tgt_free_type);
 			if (++nshrinked == tgt_nshrink)
@@ -274,6 +280,7 @@ static unsigned int __bpf_lru_list_shrink(struct bpf_lru *lru,
 	list_for_each_entry_safe_reverse(node, tmp_node, force_shrink_list,
 					 list) {
 		if (lru->del_from_htab(lru->del_arg, node)) {
+			bpf_lru_count_evicted(lru);
 			__bpf_lru_node_move_to_free(l, node, free_list,
 						    tgt_free_type);
 			return 1;
@@ -380,6 +387,7 @@ __local_list_pop_pending(struct bpf_lru *lru, struct bpf_lru_locallist *loc_l)
 				    list) {
 		if ((!bpf_lru_node_is_ref(node) || force) &&
 		    lru->del_from_htab(lru->del_arg, node)) {
+			bpf_lru_count_evicted(lru);
 			list_del(&node->list);
 			return node;
 		}
@@ -648,10 +656,14 @@ int bpf_lru_init(struct bpf_lru *lru, bool percpu, u32 hash_offset,
 {
 	int cpu;
 
+	lru->nr_evicted = alloc_percpu(unsigned long);
+	if (!lru->nr_evicted)
+		return -ENOMEM;
+
 	if (percpu) {
 		lru->percpu_lru = alloc_percpu(struct bpf_lru_list);
 		if (!lru->percpu_lru)
-			return -ENOMEM;
+			goto err_free_evicted;
 
 		for_each_possible_cpu(cpu) {
 			struct bpf_lru_list *l;
@@ -665,7 +677,7 @@ int bpf_lru_init(struct bpf_lru *lru, bool percpu, u32 hash_offset,
 
 		clru->local_list = alloc_percpu(struct bpf_lru_locallist);
 		if (!clru->local_list)
-			return -ENOMEM;
+			goto err_free_evicted;
 
 		for_each_possible_cpu(cpu) {
 			struct bpf_lru_locallist *loc_l;
@@ -684,6 +696,10 @@ int bpf_lru_init(struct bpf_lru *lru, bool percpu, u32 hash_offset,
 	lru->hash_offset = hash_offset;
 
 	return 0;
+
+err_free_evicted:
+	free_percpu(lru->nr_evicted);
+	return -ENOMEM;
 }
 
 void bpf_lru_destroy(struct bpf_lru *lru)
@@ -692,4 +708,16 @@ void bpf_lru_destroy(struct bpf_lru *lru)
 		free_percpu(lru->percpu_lru);
 	else
 		free_percpu(lru->common_lru.local_list);
+	free_percpu(lru->nr_evicted);
+}
+
+unsigned long bpf_lru_nr_evicted(const struct bpf_lru *lru)
+{
+	unsigned long sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		sum += *per_cpu_ptr(lru->nr_evicted, cpu);
+
+	return sum;
 }
@@ -57,6 +57,8 @@ struct bpf_lru {
 	};
 	del_from_htab_func del_from_htab;
 	void *del_arg;
+	/* Nodes taken away from the htab to make room for new ones */
+	unsigned long __percpu *nr_evicted;
 	unsigned int hash_offset;
 	unsigned int target_free;
 	unsigned int nr_scans;
@@ -76,5 +78,6 @@ void bpf_lru_populate(struct bpf_lru *lru, void *buf, u32 node_offset,
 void bpf_lru_destroy(struct bpf_lru *lru);
 struct bpf_lru_node *bpf_lru_pop_free(struct bpf_lru *lru, u32 hash);
 void bpf_lru_push_free(struct bpf_lru *lru, struct bpf_lru_node *node);
+unsigned long bpf_lru_nr_evicted(const struct bpf_lru *lru);
 
 #endif
@@ -303,7 +303,7 @@ static int cpu_map_kthread_run(void *data)
 	 */
 	while (!kthread_should_stop() || !__ptr_ring_empty(rcpu->queue)) {
 		struct xdp_cpumap_stats stats = {}; /* zero stats */
-		unsigned int kmem_alloc_drops = 0, sched = 0;
+		unsigned int kmem_alloc_drops = 0, sched = 0, merged = 0;
 		struct cpu_map_ret ret = { };
 		void *frames[CPUMAP_BATCH];
 		void *skbs[CPUMAP_BATCH];
@@ -389,8 +389,20 @@ static int cpu_map_kthread_run(void *data)
 		trace_xdp_cpumap_kthread(rcpu->map_id, n, kmem_alloc_drops,
 					 sched, &stats);
 
-		for (i = 0; i < ret.xdp_n + ret.skb_n; i++)
-			gro_receive_skb(&rcpu->gro, skbs[i]);
+		for (i = 0; i < ret.xdp_n + ret.skb_n; i++) {
+			switch (gro_receive_skb(&rcpu->gro, skbs[i])) {
+			case GRO_MERGED:
+			case GRO_MERGED_FREE:
+				merged++;
+				break;
+			default:
+				break;
+			}
+		}
+
+		/* Tell how much aggregation GRO achieved for this batch */
+		trace_xdp_cpumap_gro(rcpu->map_id, ret.xdp_n + ret.skb_n,
+				     merged);
 
 		/* Flush either every 64 packets or in case of empty ring */
 		packets += n;
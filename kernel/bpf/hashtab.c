@@ -12,6 +12,7 @@
 #include <uapi/linux/btf.h>
 #include <linux/rcupdate_trace.h>
 #include <linux/btf_ids.h>
+#include <linux/unaligned.h>
 #include "percpu_freelist.h"
 #include "bpf_lru_list.h"
 #include "map_in_map.h"
@@ -688,6 +689,25 @@ static inline struct hlist_nulls_head *select_bucket(struct bpf_htab *htab, u32
 	return &__select_bucket(htab, hash)->head;
 }
 
+/* Compare the common small key sizes with a couple of loads instead of an
+ * out-of-line memcmp() per element of the bucket chain. Element keys are
+ * 8 byte aligned, the caller's key (often on the BPF stack) may not be.
+ */
+static __always_inline bool htab_key_match(const struct htab_elem *l,
+					   const void *key, u32 key_size)
+{
+	switch (key_size) {
+	case 4:
+		return *(const u32 *)l->key == get_unaligned((const u32 *)key);
+	case 8:
+		return *(const u64 *)l->key == get_unaligned((const u64 *)key);
+	case 16:
+		return *(const u64 *)l->key == get_unaligned((const u64 *)key) &&
+		       *(const u64 *)(l->key + 8) == get_unaligned((const u64 *)key + 1);
+	}
+	return !memcmp(l->key, key, key_size);
+}
+
 /* this lookup function can only be called with bucket lock taken */
 static struct htab_elem *lookup_elem_raw(struct hlist_nulls_head *head, u32 hash,
 					 void *key, u32 key_size)
@@ -696,7 +716,7 @@ static struct htab_elem *lookup_elem_raw(struct hlist_nulls_head *head, u32 hash
 	struct htab_elem *l;
 
 	hlist_nulls_for_each_entry_rcu(l, n, head, hash_node)
-		if (l->hash == hash && !memcmp(&l->key, key, key_size))
+		if (l->hash == hash && htab_key_match(l, key, key_size))
 			return l;
 
 	return NULL;
@@ -715,7 +735,7 @@ static struct htab_elem *lookup_nulls_elem_raw(struct hlist_nulls_head *head,
 
 again:
 	hlist_nulls_for_each_entry_rcu(l, n, head, hash_node)
-		if (l->hash == hash && !memcmp(&l->key, key, key_size))
+		if (l->hash == hash && htab_key_match(l, key, key_size))
 			return l;
 
 	if (unlikely(get_nulls_value(n) != (hash & (n_buckets - 1))))
@@ -2347,6 +2367,14 @@ static u64 htab_map_mem_usage(const struct bpf_map *map)
 	return usage;
 }
 
+static void htab_lru_map_show_fdinfo(const struct bpf_map *map,
+				     struct seq_file *m)
+{
+	struct bpf_htab *htab = container_of(map, struct bpf_htab, map);
+
+	seq_printf(m, "lru_evictions:\t%lu\n", bpf_lru_nr_evicted(&htab->lru));
+}
+
 BTF_ID_LIST_SINGLE(htab_map_btf_ids, struct, bpf_htab)
 const struct bpf_map_ops htab_map_ops = {
 	.map_meta_equal = bpf_map_meta_equal,
@@ -2388,6 +2416,7 @@ const struct bpf_map_ops htab_lru_map_ops = {
 	.map_for_each_callback = bpf_for_each_hash_elem,
 	.map_check_btf = htab_map_check_btf,
 	.map_mem_usage = htab_map_mem_usage,
+	.map_show_fdinfo = htab_lru_map_show_fdinfo,
 	BATCH_OPS(htab_lru),
 	.map_btf_id = &htab_map_btf_ids[0],
 	.iter_seq_info = &iter_seq_info,
@@ -2589,6 +2618,7 @@ const struct bpf_map_ops htab_lru_percpu_map_ops = {
 	.map_for_each_callback = bpf_for_each_hash_elem,
 	.map_check_btf = htab_map_check_btf,
 	.map_mem_usage = htab_map_mem_usage,
+	.map_show_fdinfo = htab_lru_map_show_fdinfo,
 	BATCH_OPS(htab_lru_percpu),
 	.map_btf_id = &htab_map_btf_ids[0],
 	.iter_seq_info = &iter_seq_info,
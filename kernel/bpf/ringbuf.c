@@ -475,6 +475,17 @@ static void *__bpf_ringbuf_reserve(struct bpf_ringbuf *rb, u64 size)
 
 	cons_pos = smp_load_acquire(&rb->consumer_pos);
 
+	/*
+	 * Fail without taking the lock when the ring is already full relative
+	 * to the consumer. producer_pos only grows, so if a possibly stale value
+	 * leaves no room, the check under the lock cannot find any either. This
+	 * keeps producers of a full ring from piling up on the spinlock just to
+	 * drop their records.
+	 */
+	if (likely(!rb->overwrite_mode) &&
+	    READ_ONCE(rb->producer_pos) + len - cons_pos > rb->mask)
+		return NULL;
+
 	if (raw_res_spin_lock_irqsave(&rb->spinlock, flags))
 		return NULL;
 
@@ -15,6 +15,7 @@
 #include <linux/module.h>
 #include <linux/pci.h>
 #include <linux/platform_device.h>
+#include <linux/scatterlist.h>
 #include <linux/slab.h>
 #include <linux/timekeeping.h>
 #include <uapi/linux/map_benchmark.h>
@@ -36,14 +37,29 @@ static int map_benchmark_thread(void *data)
 	void *buf;
 	dma_addr_t dma_addr;
 	struct map_benchmark_data *map = data;
+	bool sg_mode = map->bparam.map_mode == DMA_MAP_SG_MODE;
 	int npages = map->bparam.granule;
 	u64 size = npages * PAGE_SIZE;
+	struct sg_table sgt;
+	struct scatterlist *sg;
 	int ret = 0;
+	int i;
 
 	buf = alloc_pages_exact(size, GFP_KERNEL);
 	if (!buf)
 		return -ENOMEM;
 
+	/* in sg mode, granule is the number of PAGE_SIZE segments */
+	if (sg_mode) {
+		ret = sg_alloc_table(&sgt, npages, GFP_KERNEL);
+		if (ret) {
+			free_pages_exact(buf, size);
+			return ret;
+		}
+		for_each_sgtable_sg(&sgt, sg, i)
+			sg_set_buf(sg, buf + i * PAGE_SIZE, PAGE_SIZE);
+	}
+
 	while (!kthread_should_stop())  {
 		u64 map_100ns, unmap_100ns, map_sq, unmap_sq;
 		ktime_t map_stime, map_etime, unmap_stime, unmap_etime;
@@ -59,12 +75,21 @@ static int map_benchmark_thread(void *data)
 			memset(buf, 0x66, size);
 
 		map_stime = ktime_get();
-		dma_addr = dma_map_single(map->dev, buf, size, map->dir);
-		if (unlikely(dma_mapping_error(map->dev, dma_addr))) {
-			pr_err("dma_map_single failed on %s\n",
-				dev_name(map->dev));
-			ret = -ENOMEM;
-			goto out;
+		if (sg_mode) {
+			ret = dma_map_sgtable(map->dev, &sgt, map->dir, 0);
+			if (unlikely(ret)) {
+				pr_err("dma_map_sgtable failed on %s\n",
+					dev_name(map->dev));
+				goto out;
+			}
+		} else {
+			dma_addr = dma_map_single(map->dev, buf, size, map->dir);
+			if (unlikely(dma_mapping_error(map->dev, dma_addr))) {
+				pr_err("dma_map_single failed on %s\n",
+					dev_name(map->dev));
+				ret = -ENOMEM;
+				goto out;
+			}
 		}
 		map_etime = ktime_get();
 		map_delta = ktime_sub(map_etime, map_stime);
@@ -73,7 +98,10 @@ static int map_benchmark_thread(void *data)
 		ndelay(map->bparam.dma_trans_ns);
 
 		unmap_stime = ktime_get();
-		dma_unmap_single(map->dev, dma_addr, size, map->dir);
+		if (sg_mode)
+			dma_unmap_sgtable(map->dev, &sgt, map->dir, 0);
+		else
+			dma_unmap_single(map->dev, dma_addr, size, map->dir);
 		unmap_etime = ktime_get();
 		unmap_delta = ktime_sub(unmap_etime, unmap_stime);
 
@@ -108,6 +136,8 @@ static int map_benchmark_thread(void *data)
 	}
 
 out:
+	if (sg_mode)
+		sg_free_table(&sgt);
 	free_pages_exact(buf, size);
 	return ret;
 }
@@ -238,6 +268,12 @@ static long map_benchmark_ioctl(struct file *file, unsigned int cmd,
 			return -EINVAL;
 		}
 
+		if (map->bparam.map_mode != DMA_MAP_SINGLE_MODE &&
+		    map->bparam.map_mode != DMA_MAP_SG_MODE) {
+			pr_err("invalid map mode\n");
+			return -EINVAL;
+		}
+
 		switch (map->bparam.dma_dir) {
 		case DMA_MAP_BIDIRECTIONAL:
 			map->dir = DMA_BIDIRECTIONAL;
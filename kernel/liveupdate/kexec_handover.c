@@ -461,20 +461,29 @@ static void __init deserialize_bitmap(unsigned int order,
 				      struct khoser_mem_bitmap_ptr *elm)
 {
 	struct kho_mem_phys_bits *bitmap = KHOSER_LOAD_PTR(elm->bitmap);
-	unsigned long bit;
+	unsigned long start, end, bit;
+	union kho_page_info info;
+
+	info.magic = KHO_PAGE_MAGIC;
+	info.order = order;
 
-	for_each_set_bit(bit, bitmap->preserve, PRESERVE_BITS) {
-		int sz = 1 << (order + PAGE_SHIFT);
+	/*
+	 * Large preservations show up as long runs of set bits, reserve each
+	 * run with a single memblock call instead of one call per block.
+	 */
+	for_each_set_bitrange(start, end, bitmap->preserve, PRESERVE_BITS) {
 		phys_addr_t phys =
-			elm->phys_start + (bit << (order + PAGE_SHIFT));
-		struct page *page = phys_to_page(phys);
-		union kho_page_info info;
+			elm->phys_start + (start << (order + PAGE_SHIFT));
+		phys_addr_t sz =
+			(phys_addr_t)(end - start) << (order + PAGE_SHIFT);
 
 		memblock_reserve(phys, sz);
 		memblock_reserved_mark_noinit(phys, sz);
-		info.magic = KHO_PAGE_MAGIC;
-		info.order = order;
-		page->private = info.page_private;
+
+		for (bit = start; bit < end; bit++) {
+			phys = elm->phys_start + (bit << (order + PAGE_SHIFT));
+			phys_to_page(phys)->private = info.page_private;
+		}
 	}
 }
 
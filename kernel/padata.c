@@ -45,7 +45,7 @@ struct padata_mt_job_state {
 };
 
 static void padata_free_pd(struct parallel_data *pd);
-static void __init padata_mt_helper(struct work_struct *work);
+static void padata_mt_helper(struct work_struct *work);
 
 static inline void padata_get_pd(struct parallel_data *pd)
 {
@@ -88,15 +88,7 @@ static struct padata_work *padata_work_alloc(void)
 	return pw;
 }
 
-/*
- * This function is marked __ref because this function may be optimized in such
- * a way that it directly refers to work_fn's address, which causes modpost to
- * complain when work_fn is marked __init. This scenario was observed with clang
- * LTO, where padata_work_init() was optimized to refer directly to
- * padata_mt_helper() because the calls to padata_work_init() with other work_fn
- * values were eliminated or inlined.
- */
-static void __ref padata_work_init(struct padata_work *pw, work_func_t work_fn,
+static void padata_work_init(struct padata_work *pw, work_func_t work_fn,
 				   void *data, int flags)
 {
 	if (flags & PADATA_WORK_ONSTACK)
@@ -106,8 +98,8 @@ static void __ref padata_work_init(struct padata_work *pw, work_func_t work_fn,
 	pw->pw_data = data;
 }
 
-static int __init padata_work_alloc_mt(int nworks, void *data,
-				       struct list_head *head)
+static int padata_work_alloc_mt(int nworks, void *data,
+				struct list_head *head)
 {
 	int i;
 
@@ -132,7 +124,7 @@ static void padata_work_free(struct padata_work *pw)
 	list_add(&pw->pw_list, &padata_free_works);
 }
 
-static void __init padata_works_free(struct list_head *works)
+static void padata_works_free(struct list_head *works)
 {
 	struct padata_work *cur, *next;
 
@@ -401,7 +393,7 @@ static int padata_setup_cpumasks(struct padata_instance *pinst)
 	return err;
 }
 
-static void __init padata_mt_helper(struct work_struct *w)
+static void padata_mt_helper(struct work_struct *w)
 {
 	struct padata_work *pw = container_of(w, struct padata_work, pw_work);
 	struct padata_mt_job_state *ps = pw->pw_data;
@@ -440,8 +432,10 @@ static void __init padata_mt_helper(struct work_struct *w)
  * @job: Description of the job.
  *
  * See the definition of struct padata_mt_job for more details.
+ *
+ * Context: Process context, may sleep until the whole job is done.
  */
-void __init padata_do_multithreaded(struct padata_mt_job *job)
+void padata_do_multithreaded(struct padata_mt_job *job)
 {
 	/* In case threads finish at different times. */
 	static const unsigned long load_balance_factor = 4;
@@ -449,7 +443,7 @@ void __init padata_do_multithreaded(struct padata_mt_job *job)
 	struct padata_mt_job_state ps;
 	LIST_HEAD(works);
 	int nworks, nid;
-	static atomic_t last_used_nid __initdata;
+	static atomic_t last_used_nid;
 
 	if (job->size == 0)
 		return;
@@ -458,6 +452,14 @@ void __init padata_do_multithreaded(struct padata_mt_job *job)
 	nworks = max(job->size / max(job->min_chunk, job->align), 1ul);
 	nworks = min(nworks, job->max_threads);
 
+	/*
+	 * Once the system is up, don't let a single job fan out wider than the
+	 * CPUs its caller is confined to, so cpuset limits on the task that
+	 * asked for the work still bound how much of the machine it takes.
+	 */
+	if (system_state == SYSTEM_RUNNING)
+		nworks = min(nworks, (int)cpumask_weight(current->cpus_ptr));
+
 	if (nworks == 1) {
 		/* Single thread, no coordination needed, cut to the chase. */
 		job->thread_fn(job->start, job->start + job->size, job->fn_arg);
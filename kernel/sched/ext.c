@@ -1931,8 +1931,15 @@ static bool consume_dispatch_q(struct scx_sched *sch, struct rq *rq,
 		}
 
 		if (task_can_run_on_remote_rq(sch, p, rq, false)) {
-			if (likely(consume_remote_task(rq, p, dsq, task_rq)))
+			int src_cpu = cpu_of(task_rq);
+
+			if (likely(consume_remote_task(rq, p, dsq, task_rq))) {
+				__scx_add_event(sch, SCX_EV_CONSUME_REMOTE, 1);
+				if (!cpus_share_cache(cpu_of(rq), src_cpu))
+					__scx_add_event(sch,
+						SCX_EV_CONSUME_REMOTE_CROSS_LLC, 1);
 				return true;
+			}
 			goto retry;
 		}
 	}
@@ -3784,6 +3791,8 @@ static ssize_t scx_attr_events_show(struct kobject *kobj,
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_SELECT_CPU_FALLBACK);
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_DISPATCH_LOCAL_DSQ_OFFLINE);
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_DISPATCH_KEEP_LAST);
+	at += scx_attr_event_show(buf, at, &events, SCX_EV_CONSUME_REMOTE);
+	at += scx_attr_event_show(buf, at, &events, SCX_EV_CONSUME_REMOTE_CROSS_LLC);
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_ENQ_SKIP_EXITING);
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_ENQ_SKIP_MIGRATION_DISABLED);
 	at += scx_attr_event_show(buf, at, &events, SCX_EV_REFILL_SLICE_DFL);
@@ -4812,6 +4821,8 @@ static void scx_dump_state(struct scx_exit_info *ei, size_t dump_len)
 	scx_dump_event(s, &events, SCX_EV_SELECT_CPU_FALLBACK);
 	scx_dump_event(s, &events, SCX_EV_DISPATCH_LOCAL_DSQ_OFFLINE);
 	scx_dump_event(s, &events, SCX_EV_DISPATCH_KEEP_LAST);
+	scx_dump_event(s, &events, SCX_EV_CONSUME_REMOTE);
+	scx_dump_event(s, &events, SCX_EV_CONSUME_REMOTE_CROSS_LLC);
 	scx_dump_event(s, &events, SCX_EV_ENQ_SKIP_EXITING);
 	scx_dump_event(s, &events, SCX_EV_ENQ_SKIP_MIGRATION_DISABLED);
 	scx_dump_event(s, &events, SCX_EV_REFILL_SLICE_DFL);
@@ -7365,6 +7376,8 @@ static void scx_read_events(struct scx_sched *sch, struct scx_event_stats *event
 		scx_agg_event(events, e_cpu, SCX_EV_SELECT_CPU_FALLBACK);
 		scx_agg_event(events, e_cpu, SCX_EV_DISPATCH_LOCAL_DSQ_OFFLINE);
 		scx_agg_event(events, e_cpu, SCX_EV_DISPATCH_KEEP_LAST);
+		scx_agg_event(events, e_cpu, SCX_EV_CONSUME_REMOTE);
+		scx_agg_event(events, e_cpu, SCX_EV_CONSUME_REMOTE_CROSS_LLC);
 		scx_agg_event(events, e_cpu, SCX_EV_ENQ_SKIP_EXITING);
 		scx_agg_event(events, e_cpu, SCX_EV_ENQ_SKIP_MIGRATION_DISABLED);
 		scx_agg_event(events, e_cpu, SCX_EV_REFILL_SLICE_DFL);
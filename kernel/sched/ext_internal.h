@@ -840,6 +840,13 @@ struct scx_event_stats {
 	 */
 	s64		SCX_EV_DISPATCH_KEEP_LAST;
 
+	/*
+	 * The number of tasks a CPU pulled from another CPU's rq while
+	 * consuming a DSQ, and how many of those crossed an LLC boundary.
+	 */
+	s64		SCX_EV_CONSUME_REMOTE;
+	s64		SCX_EV_CONSUME_REMOTE_CROSS_LLC;
+
 	/*
 	 * If SCX_OPS_ENQ_EXITING is not set, the number of times that a task
 	 * is dispatched to a local DSQ when exiting.
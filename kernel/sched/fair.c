@@ -1110,6 +1110,31 @@ int sched_update_scaling(void)
 
 static void clear_buddies(struct cfs_rq *cfs_rq, struct sched_entity *se);
 
+static u64 default_slice(struct sched_entity *se)
+{
+	u64 slice = sysctl_sched_base_slice;
+
+	/*
+	 * A task that typically sleeps well within the base slice asks for
+	 * about as much as it runs, which gets it an earlier deadline.
+	 */
+	if (sched_feat(AUTO_SLICE) && se->burst_avg)
+		slice = min(slice, max_t(u64, se->burst_avg, NSEC_PER_MSEC/10));
+
+	return slice;
+}
+
+static void update_burst_avg(struct sched_entity *se)
+{
+	u64 burst = se->sum_exec_runtime - se->burst_start;
+
+	se->burst_start = se->sum_exec_runtime;
+	if (!se->burst_avg)
+		se->burst_avg = burst;
+	else
+		se->burst_avg = (7 * se->burst_avg + burst) / 8;
+}
+
 /*
  * XXX: strictly: vd_i += N*r_i/w_i such that: vd_i > ve_i
  * this is probably good enough.
@@ -1125,7 +1150,7 @@ static bool update_deadline(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	 * sysctl_sched_base_slice.
 	 */
 	if (!se->custom_slice)
-		se->slice = sysctl_sched_base_slice;
+		se->slice = default_slice(se);
 
 	/*
 	 * EEVDF: vd_i = ve_i + r_i / w_i
@@ -5167,7 +5192,7 @@ place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 	s64 lag = 0;
 
 	if (!se->custom_slice)
-		se->slice = sysctl_sched_base_slice;
+		se->slice = default_slice(se);
 	vslice = calc_delta_fair(se->slice, se);
 
 	/*
@@ -5414,6 +5439,10 @@ dequeue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 	update_curr(cfs_rq);
 	clear_buddies(cfs_rq, se);
 
+	if (sched_feat(AUTO_SLICE) && sleep && !(flags & DEQUEUE_DELAYED) &&
+	    entity_is_task(se))
+		update_burst_avg(se);
+
 	if (flags & DEQUEUE_DELAYED) {
 		WARN_ON_ONCE(!se->sched_delayed);
 	} else {
@@ -7834,6 +7863,42 @@ static inline bool asym_fits_cpu(unsigned long util,
 	return true;
 }
 
+/*
+ * Nothing idle in the target's LLC. Walk the other LLCs below the same
+ * (non-NUMA) parent domain and scan the first one whose has_idle_cores hint
+ * is set. Checking the hint costs a single read per sibling LLC, busy LLCs
+ * are never probed CPU by CPU.
+ */
+static int select_idle_llc(struct task_struct *p, struct sched_domain *sd, int target)
+{
+	struct sched_domain *parent = sd->parent;
+	struct sched_group *sg;
+	int cpu, i;
+
+	if (!parent || (parent->flags & SD_NUMA))
+		return -1;
+
+	/* The first group is the one spanning @target, skip it. */
+	for (sg = parent->groups->next; sg != parent->groups; sg = sg->next) {
+		if (!cpumask_intersects(sched_group_span(sg), p->cpus_ptr))
+			continue;
+
+		cpu = cpumask_first(sched_group_span(sg));
+		if (cpus_share_cache(cpu, target) || !test_idle_cores(cpu))
+			continue;
+
+		sd = rcu_dereference_all(per_cpu(sd_llc, cpu));
+		if (!sd)
+			continue;
+
+		i = select_idle_cpu(p, sd, true, cpu);
+		if ((unsigned int)i < nr_cpumask_bits)
+			return i;
+	}
+
+	return -1;
+}
+
 /*
  * Try and locate an idle core/thread in the LLC cache domain.
  */
@@ -7961,6 +8026,12 @@ static int select_idle_sibling(struct task_struct *p, int prev, int target)
 	if ((unsigned int)recent_used_cpu < nr_cpumask_bits)
 		return recent_used_cpu;
 
+	if (sched_feat(SIS_NEIGHBOR_LLC) && sched_smt_active()) {
+		i = select_idle_llc(p, sd, target);
+		if ((unsigned int)i < nr_cpumask_bits)
+			return i;
+	}
+
 	return target;
 }
 
@@ -9382,13 +9453,6 @@ static int task_hot(struct task_struct *p, struct lb_env *env)
 	if (sysctl_sched_migration_cost == -1)
 		return 1;
 
-	/*
-	 * Don't migrate task if the task's cookie does not match
-	 * with the destination CPU's core cookie.
-	 */
-	if (!sched_core_cookie_match(cpu_rq(env->dst_cpu), p))
-		return 1;
-
 	if (sysctl_sched_migration_cost == 0)
 		return 0;
 
@@ -9576,6 +9640,23 @@ int can_migrate_task(struct task_struct *p, struct lb_env *env)
 	if (env->flags & LBF_ACTIVE_LB)
 		return 1;
 
+	/*
+	 * Don't migrate task if the task's cookie does not match with the
+	 * destination CPU's core cookie: one of the siblings would be forced
+	 * idle, which costs more than the cache or NUMA locality that could
+	 * be gained. Only give in when balancing keeps failing otherwise.
+	 * Tasks task_hot() never considered hot, SCHED_IDLE ones and those
+	 * of other classes, keep migrating freely across cookies.
+	 */
+	if (p->sched_class == &fair_sched_class &&
+	    !task_has_idle_policy(p) &&
+	    !(env->sd->flags & SD_SHARE_CPUCAPACITY) &&
+	    !sched_core_cookie_match(env->dst_rq, p) &&
+	    env->sd->nr_balance_failed <= env->sd->cache_nice_tries) {
+		schedstat_inc(p->stats.nr_failed_migrations_cookie);
+		return 0;
+	}
+
 	degrades = migrate_degrades_locality(p, env);
 	if (!degrades)
 		hot = task_hot(p, env);
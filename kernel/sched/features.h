@@ -23,6 +23,11 @@ SCHED_FEAT(RUN_TO_PARITY, true)
  * current.
  */
 SCHED_FEAT(PREEMPT_SHORT, true)
+/*
+ * Size the request of tasks without a custom slice after their average run
+ * time between sleeps, bounded by the base slice.
+ */
+SCHED_FEAT(AUTO_SLICE, false)
 
 /*
  * Prefer to schedule the task we woke last (assuming it failed
@@ -87,6 +92,12 @@ SCHED_FEAT(TTWU_QUEUE, true)
  */
 SCHED_FEAT(SIS_UTIL, true)
 
+/*
+ * When the LLC has no idle CPU, look for an idle core in the sibling LLCs
+ * sharing the next (non-NUMA) topology level before stacking on the target.
+ */
+SCHED_FEAT(SIS_NEIGHBOR_LLC, false)
+
 /*
  * Issue a WARN when we do multiple update_rq_clock() calls
  * in a single rq->lock section. Default disabled because the
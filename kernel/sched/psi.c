@@ -798,6 +798,7 @@ static void psi_group_change(struct psi_group *group, int cpu,
 			     u64 now, bool wake_clock)
 {
 	struct psi_group_cpu *groupc;
+	bool resync = !clear && !set;
 	unsigned int t, m;
 	u32 state_mask;
 
@@ -871,9 +872,18 @@ static void psi_group_change(struct psi_group *group, int cpu,
 	if (unlikely((state_mask & PSI_ONCPU) && cpu_curr(cpu)->in_memstall))
 		state_mask |= (1 << PSI_MEM_FULL);
 
-	record_times(groupc, now);
-
-	groupc->state_mask = state_mask;
+	/*
+	 * Task count changes often leave the state of a group as it was,
+	 * especially for ancestors high up a deep hierarchy. There is no
+	 * need to close the running state interval then: the time is the
+	 * same whether it is accounted now or at the next real transition,
+	 * and readers add the open interval from state_start themselves.
+	 * A resync after re-enabling must restart the interval, though.
+	 */
+	if (state_mask != groupc->state_mask || resync) {
+		record_times(groupc, now);
+		groupc->state_mask = state_mask;
+	}
 
 	if (state_mask & group->rtpoll_states)
 		psi_schedule_rtpoll_work(group, 1, false);
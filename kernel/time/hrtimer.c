@@ -309,6 +309,7 @@ lock_hrtimer_base(const struct hrtimer *timer, unsigned long *flags)
 	return base;
 }
 
+# define get_target_base(b, p)		(b)
 # define switch_hrtimer_base(t, b, p)	(b)
 
 #endif	/* !CONFIG_SMP */
@@ -1215,6 +1216,33 @@ hrtimer_update_softirq_timer(struct hrtimer_cpu_base *cpu_base, bool reprogram)
 	hrtimer_reprogram(cpu_base->softirq_next_timer, reprogram);
 }
 
+/*
+ * Re-arming a queued timer to an expiry time which keeps its position in
+ * the timerqueue does not need the rbtree erase and insert. This is only
+ * done for timers which are not the first one in their clock base, so
+ * neither the clock event device nor the softirq expiry need an update.
+ */
+static bool hrtimer_requeue_in_place(struct hrtimer *timer, ktime_t tim,
+				     u64 delta_ns)
+{
+	ktime_t expires = ktime_add_safe(tim, ns_to_ktime(delta_ns));
+	struct rb_node *prev, *next;
+
+	if (!(timer->state & HRTIMER_STATE_ENQUEUED))
+		return false;
+
+	prev = rb_prev(&timer->node.node);
+	if (!prev || rb_entry(prev, struct timerqueue_node, node)->expires > expires)
+		return false;
+
+	next = rb_next(&timer->node.node);
+	if (next && rb_entry(next, struct timerqueue_node, node)->expires < expires)
+		return false;
+
+	hrtimer_set_expires_range_ns(timer, tim, delta_ns);
+	return true;
+}
+
 static int __hrtimer_start_range_ns(struct hrtimer *timer, ktime_t tim,
 				    u64 delta_ns, const enum hrtimer_mode mode,
 				    struct hrtimer_clock_base *base)
@@ -1223,6 +1251,27 @@ static int __hrtimer_start_range_ns(struct hrtimer *timer, ktime_t tim,
 	struct hrtimer_clock_base *new_base;
 	bool force_local, first;
 
+	if (mode & HRTIMER_MODE_REL)
+		tim = ktime_add_safe(tim, __hrtimer_cb_get_time(base->clockid));
+
+	tim = hrtimer_update_lowres(timer, tim, mode);
+
+	/*
+	 * Timers which are pushed back a little on every event, like
+	 * pacing and retransmit timers, mostly stay in place relative to
+	 * their neighbours. Keep a local one where it is in that case,
+	 * unless the restart would move it to another CPU base, e.g. the
+	 * NOHZ timer target.
+	 */
+	if (base->cpu_base == this_cpu_base &&
+	    get_target_base(this_cpu_base,
+			    mode & HRTIMER_MODE_PINNED) == this_cpu_base &&
+	    hrtimer_requeue_in_place(timer, tim, delta_ns)) {
+		debug_deactivate(timer);
+		debug_activate(timer, mode);
+		return 0;
+	}
+
 	/*
 	 * If the timer is on the local cpu base and is the first expiring
 	 * timer then this might end up reprogramming the hardware twice
@@ -1253,11 +1302,6 @@ static int __hrtimer_start_range_ns(struct hrtimer *timer, ktime_t tim,
 	 */
 	remove_hrtimer(timer, base, true, force_local);
 
-	if (mode & HRTIMER_MODE_REL)
-		tim = ktime_add_safe(tim, __hrtimer_cb_get_time(base->clockid));
-
-	tim = hrtimer_update_lowres(timer, tim, mode);
-
 	hrtimer_set_expires_range_ns(timer, tim, delta_ns);
 
 	/* Switch the timer base, if necessary: */
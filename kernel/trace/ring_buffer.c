@@ -5598,18 +5598,12 @@ rb_get_reader_page(struct ring_buffer_per_cpu *cpu_buffer)
 	return reader;
 }
 
-static void rb_advance_reader(struct ring_buffer_per_cpu *cpu_buffer)
+/* Consume the next event on the current reader page */
+static void __rb_advance_reader(struct ring_buffer_per_cpu *cpu_buffer)
 {
 	struct ring_buffer_event *event;
-	struct buffer_page *reader;
 	unsigned length;
 
-	reader = rb_get_reader_page(cpu_buffer);
-
-	/* This function should not be called when buffer is empty */
-	if (RB_WARN_ON(cpu_buffer, !reader))
-		return;
-
 	event = rb_reader_event(cpu_buffer);
 
 	if (event->type_len <= RINGBUF_TYPE_DATA_TYPE_LEN_MAX)
@@ -5622,6 +5616,19 @@ static void rb_advance_reader(struct ring_buffer_per_cpu *cpu_buffer)
 	cpu_buffer->read_bytes += length;
 }
 
+static void rb_advance_reader(struct ring_buffer_per_cpu *cpu_buffer)
+{
+	struct buffer_page *reader;
+
+	reader = rb_get_reader_page(cpu_buffer);
+
+	/* This function should not be called when buffer is empty */
+	if (RB_WARN_ON(cpu_buffer, !reader))
+		return;
+
+	__rb_advance_reader(cpu_buffer);
+}
+
 static void rb_advance_iter(struct ring_buffer_iter *iter)
 {
 	struct ring_buffer_per_cpu *cpu_buffer;
@@ -7394,8 +7401,15 @@ int ring_buffer_map_get_reader(struct trace_buffer *buffer, int cpu)
 	 * everything. Let's update the kernel reader accordingly.
 	 */
 	if (cpu_buffer->reader_page->read < reader_size) {
+		/*
+		 * Only the reader swaps the reader page, and we hold the
+		 * reader_lock, so look it up once rather than taking the
+		 * cpu_buffer->lock again for every event on the page.
+		 */
+		if (WARN_ON(!rb_get_reader_page(cpu_buffer)))
+			goto out;
 		while (cpu_buffer->reader_page->read < reader_size)
-			rb_advance_reader(cpu_buffer);
+			__rb_advance_reader(cpu_buffer);
 		goto out;
 	}
 
@@ -235,6 +235,11 @@ static inline struct osnoise_variables *this_cpu_osn_var(void)
 static struct mutex interface_lock;
 
 #ifdef CONFIG_TIMERLAT_TRACER
+/*
+ * Number of log2 buckets, in us, of the timerlat IRQ latency histogram.
+ */
+#define TIMERLAT_HIST_BUCKETS	32
+
 /*
  * Runtime information for the timer mode.
  */
@@ -246,6 +251,7 @@ struct timerlat_variables {
 	bool			tracing_thread;
 	u64			count;
 	bool			uthread_migrate;
+	u64			irq_hist[TIMERLAT_HIST_BUCKETS];
 };
 
 static DEFINE_PER_CPU(struct timerlat_variables, per_cpu_timerlat_var);
@@ -1710,6 +1716,18 @@ static int osnoise_main(void *data)
 }
 
 #ifdef CONFIG_TIMERLAT_TRACER
+/*
+ * timerlat_hist_bucket - Return the irq_hist bucket of a latency in ns
+ *
+ * Bucket 0 holds latencies below 1 us, bucket n holds [2^(n-1), 2^n) us,
+ * and the last bucket also collects everything above it.
+ */
+static inline unsigned int timerlat_hist_bucket(u64 latency)
+{
+	return min_t(unsigned int, fls64(time_to_us(latency)),
+		     TIMERLAT_HIST_BUCKETS - 1);
+}
+
 /*
  * timerlat_irq - hrtimer handler for timerlat.
  */
@@ -1775,6 +1793,7 @@ static enum hrtimer_restart timerlat_irq(struct hrtimer *timer)
 	diff = now - tlat->abs_period;
 
 	tlat->count++;
+	tlat->irq_hist[timerlat_hist_bucket(diff)]++;
 	s.seqnum = tlat->count;
 	s.timer_latency = diff;
 	s.context = IRQ_CONTEXT;
@@ -2656,6 +2675,35 @@ static const struct file_operations timerlat_fd_fops = {
 	.release	= timerlat_fd_release,
 	.llseek		= generic_file_llseek,
 };
+
+/*
+ * timerlat_irq_hist_show - Print the per-cpu timerlat IRQ latency histogram
+ *
+ * The first line has the lower bound, in us, of each bucket. It is
+ * followed by one line of counts per online CPU. The counters are reset
+ * every time the timerlat tracer starts.
+ */
+static int timerlat_irq_hist_show(struct seq_file *s, void *v)
+{
+	struct timerlat_variables *tlat_var;
+	int cpu, i;
+
+	seq_puts(s, "# us:");
+	for (i = 0; i < TIMERLAT_HIST_BUCKETS; i++)
+		seq_printf(s, " %llu", i ? 1ULL << (i - 1) : 0ULL);
+	seq_putc(s, '\n');
+
+	for_each_online_cpu(cpu) {
+		tlat_var = per_cpu_ptr(&per_cpu_timerlat_var, cpu);
+		seq_printf(s, "cpu%d:", cpu);
+		for (i = 0; i < TIMERLAT_HIST_BUCKETS; i++)
+			seq_printf(s, " %llu", READ_ONCE(tlat_var->irq_hist[i]));
+		seq_putc(s, '\n');
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(timerlat_irq_hist);
 #endif
 
 static const struct file_operations cpus_fops = {
@@ -2746,6 +2794,11 @@ static int init_timerlat_tracefs(struct dentry *top_dir)
 	if (!tmp)
 		return -ENOMEM;
 
+	tmp = tracefs_create_file("timerlat_irq_hist", TRACE_MODE_READ, top_dir,
+				  NULL, &timerlat_irq_hist_fops);
+	if (!tmp)
+		return -ENOMEM;
+
 	retval = osnoise_create_cpu_timerlat_fd(top_dir);
 	if (retval)
 		return retval;
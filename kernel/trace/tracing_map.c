@@ -563,6 +563,17 @@ __tracing_map_insert(struct tracing_map *map, void *key, bool lookup_only)
 			if (lookup_only)
 				break;
 
+			/*
+			 * All elts are in use, so this new key can only be
+			 * dropped. Don't claim and then release an empty
+			 * slot, which would dirty the shared table on every
+			 * miss once the map is full.
+			 */
+			if (atomic_read(&map->next_elt) >= map->max_elts) {
+				atomic64_inc(&map->drops);
+				break;
+			}
+
 			if (!cmpxchg(&entry->key, 0, key_hash)) {
 				struct tracing_map_elt *elt;
 
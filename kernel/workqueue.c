@@ -245,6 +245,7 @@ enum pool_workqueue_stats {
 	PWQ_STAT_CPU_INTENSIVE,	/* wq_cpu_intensive_thresh_us violations */
 	PWQ_STAT_CM_WAKEUP,	/* concurrency-management worker wakeups */
 	PWQ_STAT_REPATRIATED,	/* unbound workers brought back into scope */
+	PWQ_STAT_STOLEN,	/* unbound workers sent to another pod's idle CPU */
 	PWQ_STAT_MAYDAY,	/* maydays to rescuer */
 	PWQ_STAT_RESCUED,	/* linked work items executed by rescuer */
 
@@ -1242,6 +1243,29 @@ static void kick_bh_pool(struct worker_pool *pool)
 		raise_softirq_irqoff(TASKLET_SOFTIRQ);
 }
 
+#ifdef CONFIG_SMP
+/*
+ * With affn_steal, pick an idle CPU outside @pool's pod once the pod's CPUs
+ * are all taken by busy workers, so that other pods can help with the
+ * backlog. Returns nr_cpu_ids if the worker should stay in the pod.
+ */
+static int pool_steal_cpu(struct worker_pool *pool)
+{
+	const struct cpumask *pod_cpumask = pool->attrs->__pod_cpumask;
+	int cpu;
+
+	if (pool->nr_workers - pool->nr_idle < cpumask_weight(pod_cpumask))
+		return nr_cpu_ids;
+
+	for_each_cpu_andnot(cpu, pool->attrs->cpumask, pod_cpumask) {
+		if (cpu_online(cpu) && idle_cpu(cpu))
+			return cpu;
+	}
+
+	return nr_cpu_ids;
+}
+#endif
+
 /**
  * kick_pool - wake up an idle worker if necessary
  * @pool: pool to kick
@@ -1281,17 +1305,28 @@ static bool kick_pool(struct worker_pool *pool)
 	 * still on cpu when picking an idle worker.
 	 *
 	 * If @pool has non-strict affinity, @worker might have ended up outside
-	 * its affinity scope. Repatriate.
+	 * its affinity scope. Repatriate, unless the pod is saturated and
+	 * affn_steal lets the backlog spill over to another pod.
 	 */
-	if (!pool->attrs->affn_strict &&
-	    !cpumask_test_cpu(p->wake_cpu, pool->attrs->__pod_cpumask)) {
+	if (!pool->attrs->affn_strict) {
 		struct work_struct *work = list_first_entry(&pool->worklist,
 						struct work_struct, entry);
-		int wake_cpu = cpumask_any_and_distribute(pool->attrs->__pod_cpumask,
-							  cpu_online_mask);
+		int wake_cpu = nr_cpu_ids;
+
+		if (pool->attrs->affn_steal)
+			wake_cpu = pool_steal_cpu(pool);
+
 		if (wake_cpu < nr_cpu_ids) {
 			p->wake_cpu = wake_cpu;
-			get_work_pwq(work)->stats[PWQ_STAT_REPATRIATED]++;
+			get_work_pwq(work)->stats[PWQ_STAT_STOLEN]++;
+		} else if (!cpumask_test_cpu(p->wake_cpu,
+					     pool->attrs->__pod_cpumask)) {
+			wake_cpu = cpumask_any_and_distribute(pool->attrs->__pod_cpumask,
+							      cpu_online_mask);
+			if (wake_cpu < nr_cpu_ids) {
+				p->wake_cpu = wake_cpu;
+				get_work_pwq(work)->stats[PWQ_STAT_REPATRIATED]++;
+			}
 		}
 	}
 #endif
@@ -4738,6 +4773,7 @@ static void copy_workqueue_attrs(struct workqueue_attrs *to,
 	cpumask_copy(to->cpumask, from->cpumask);
 	cpumask_copy(to->__pod_cpumask, from->__pod_cpumask);
 	to->affn_strict = from->affn_strict;
+	to->affn_steal = from->affn_steal;
 
 	/*
 	 * Unlike hash and equality test, copying shouldn't ignore wq-only
@@ -4767,6 +4803,7 @@ static u32 wqattrs_hash(const struct workqueue_attrs *attrs)
 
 	hash = jhash_1word(attrs->nice, hash);
 	hash = jhash_1word(attrs->affn_strict, hash);
+	hash = jhash_1word(attrs->affn_steal, hash);
 	hash = jhash(cpumask_bits(attrs->__pod_cpumask),
 		     BITS_TO_LONGS(nr_cpumask_bits) * sizeof(long), hash);
 	if (!attrs->affn_strict)
@@ -4783,6 +4820,8 @@ static bool wqattrs_equal(const struct workqueue_attrs *a,
 		return false;
 	if (a->affn_strict != b->affn_strict)
 		return false;
+	if (a->affn_steal != b->affn_steal)
+		return false;
 	if (!cpumask_equal(a->__pod_cpumask, b->__pod_cpumask))
 		return false;
 	if (!a->affn_strict && !cpumask_equal(a->cpumask, b->cpumask))
@@ -7344,11 +7383,59 @@ static ssize_t wq_affinity_strict_store(struct device *dev,
 	return ret ?: count;
 }
 
+static ssize_t wq_affinity_steal_show(struct device *dev,
+				      struct device_attribute *attr, char *buf)
+{
+	struct workqueue_struct *wq = dev_to_wq(dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%d\n",
+			 wq->unbound_attrs->affn_steal);
+}
+
+static ssize_t wq_affinity_steal_store(struct device *dev,
+				       struct device_attribute *attr,
+				       const char *buf, size_t count)
+{
+	struct workqueue_struct *wq = dev_to_wq(dev);
+	struct workqueue_attrs *attrs;
+	int v, ret = -ENOMEM;
+
+	if (sscanf(buf, "%d", &v) != 1)
+		return -EINVAL;
+
+	apply_wqattrs_lock();
+	attrs = wq_sysfs_prep_attrs(wq);
+	if (attrs) {
+		attrs->affn_steal = (bool)v;
+		ret = apply_workqueue_attrs_locked(wq, attrs);
+	}
+	apply_wqattrs_unlock();
+	free_workqueue_attrs(attrs);
+	return ret ?: count;
+}
+
+static ssize_t wq_affinity_stolen_show(struct device *dev,
+				       struct device_attribute *attr, char *buf)
+{
+	struct workqueue_struct *wq = dev_to_wq(dev);
+	struct pool_workqueue *pwq;
+	u64 stolen = 0;
+
+	rcu_read_lock();
+	for_each_pwq(pwq, wq)
+		stolen += READ_ONCE(pwq->stats[PWQ_STAT_STOLEN]);
+	rcu_read_unlock();
+
+	return scnprintf(buf, PAGE_SIZE, "%llu\n", stolen);
+}
+
 static struct device_attribute wq_sysfs_unbound_attrs[] = {
 	__ATTR(nice, 0644, wq_nice_show, wq_nice_store),
 	__ATTR(cpumask, 0644, wq_cpumask_show, wq_cpumask_store),
 	__ATTR(affinity_scope, 0644, wq_affn_scope_show, wq_affn_scope_store),
 	__ATTR(affinity_strict, 0644, wq_affinity_strict_show, wq_affinity_strict_store),
+	__ATTR(affinity_steal, 0644, wq_affinity_steal_show, wq_affinity_steal_store),
+	__ATTR(affinity_stolen, 0444, wq_affinity_stolen_show, NULL),
 	__ATTR_NULL,
 };
 
@@ -3006,6 +3006,7 @@ size_t splice_folio_into_pipe(struct pipe_inode_info *pipe,
 {
 	struct page *page;
 	size_t spliced = 0, offset = offset_in_folio(folio, fpos);
+	int nr_bufs = 0;
 
 	page = folio_page(folio, offset / PAGE_SIZE);
 	size = min(size, folio_size(folio) - offset);
@@ -3021,13 +3022,20 @@ size_t splice_folio_into_pipe(struct pipe_inode_info *pipe,
 			.offset	= offset,
 			.len	= part,
 		};
-		folio_get(folio);
 		pipe->head++;
 		page++;
+		nr_bufs++;
 		spliced += part;
 		offset = 0;
 	}
 
+	/*
+	 * Take the references for all the buffers at once. Nobody can
+	 * consume them before we drop the pipe lock.
+	 */
+	if (nr_bufs)
+		folio_ref_add(folio, nr_bufs);
+
 	return spliced;
 }
 
@@ -617,6 +617,10 @@ void folio_putback_lru(struct folio *folio);
 extern void reclaim_throttle(pg_data_t *pgdat, enum vmscan_throttle_state reason);
 int user_proactive_reclaim(char *buf,
 			   struct mem_cgroup *memcg, pg_data_t *pgdat);
+#if defined(CONFIG_LRU_GEN) && defined(CONFIG_MEMCG)
+int lru_gen_memcg_show(struct seq_file *m, struct mem_cgroup *memcg);
+int lru_gen_memcg_write(char *buf, struct mem_cgroup *memcg);
+#endif
 
 /*
  * in mm/rmap.c:
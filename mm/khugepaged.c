@@ -72,6 +72,12 @@ static DEFINE_MUTEX(khugepaged_mutex);
 static unsigned int khugepaged_pages_to_scan __read_mostly;
 static unsigned int khugepaged_pages_collapsed;
 static unsigned int khugepaged_full_scans;
+/* collapses that came from fault hints rather than the linear scan */
+static unsigned int khugepaged_hint_pages_collapsed;
+/* time spent in successful khugepaged collapses, allocation included */
+static unsigned long khugepaged_collapses;
+static u64 khugepaged_collapse_time_ns;
+static u64 khugepaged_collapse_time_max_ns;
 static unsigned int khugepaged_scan_sleep_millisecs __read_mostly = 10000;
 /* during fragmentation poll the hugepage allocator once every minute */
 static unsigned int khugepaged_alloc_sleep_millisecs __read_mostly = 60000;
@@ -214,6 +220,46 @@ static ssize_t full_scans_show(struct kobject *kobj,
 static struct kobj_attribute full_scans_attr =
 	__ATTR_RO(full_scans);
 
+static ssize_t hint_pages_collapsed_show(struct kobject *kobj,
+					 struct kobj_attribute *attr,
+					 char *buf)
+{
+	return sysfs_emit(buf, "%u\n", khugepaged_hint_pages_collapsed);
+}
+static struct kobj_attribute hint_pages_collapsed_attr =
+	__ATTR_RO(hint_pages_collapsed);
+
+static ssize_t collapses_show(struct kobject *kobj,
+			      struct kobj_attribute *attr,
+			      char *buf)
+{
+	return sysfs_emit(buf, "%lu\n", READ_ONCE(khugepaged_collapses));
+}
+static struct kobj_attribute collapses_attr =
+	__ATTR_RO(collapses);
+
+static ssize_t collapse_time_us_show(struct kobject *kobj,
+				     struct kobj_attribute *attr,
+				     char *buf)
+{
+	return sysfs_emit(buf, "%llu\n",
+			  div_u64(READ_ONCE(khugepaged_collapse_time_ns),
+				  NSEC_PER_USEC));
+}
+static struct kobj_attribute collapse_time_us_attr =
+	__ATTR_RO(collapse_time_us);
+
+static ssize_t collapse_time_max_us_show(struct kobject *kobj,
+					 struct kobj_attribute *attr,
+					 char *buf)
+{
+	return sysfs_emit(buf, "%llu\n",
+			  div_u64(READ_ONCE(khugepaged_collapse_time_max_ns),
+				  NSEC_PER_USEC));
+}
+static struct kobj_attribute collapse_time_max_us_attr =
+	__ATTR_RO(collapse_time_max_us);
+
 static ssize_t defrag_show(struct kobject *kobj,
 			   struct kobj_attribute *attr, char *buf)
 {
@@ -322,6 +368,10 @@ static struct attribute *khugepaged_attr[] = {
 	&pages_to_scan_attr.attr,
 	&pages_collapsed_attr.attr,
 	&full_scans_attr.attr,
+	&hint_pages_collapsed_attr.attr,
+	&collapses_attr.attr,
+	&collapse_time_us_attr.attr,
+	&collapse_time_max_us_attr.attr,
 	&scan_sleep_millisecs_attr.attr,
 	&alloc_sleep_millisecs_attr.attr,
 	NULL,
@@ -1075,6 +1125,26 @@ static enum scan_result alloc_charge_folio(struct folio **foliop, struct mm_stru
 	return SCAN_SUCCEED;
 }
 
+/*
+ * Only khugepaged updates these, so plain stores are enough; readers in
+ * sysfs may see a total and a maximum from different collapses.
+ */
+static void khugepaged_account_collapse(struct collapse_control *cc,
+					u64 start, enum scan_result result)
+{
+	u64 delta;
+
+	if (!cc->is_khugepaged || result != SCAN_SUCCEED)
+		return;
+
+	delta = ktime_get_ns() - start;
+	WRITE_ONCE(khugepaged_collapses, khugepaged_collapses + 1);
+	WRITE_ONCE(khugepaged_collapse_time_ns,
+		   khugepaged_collapse_time_ns + delta);
+	if (delta > khugepaged_collapse_time_max_ns)
+		WRITE_ONCE(khugepaged_collapse_time_max_ns, delta);
+}
+
 static enum scan_result collapse_huge_page(struct mm_struct *mm, unsigned long address,
 		int referenced, int unmapped, struct collapse_control *cc)
 {
@@ -1087,6 +1157,7 @@ static enum scan_result collapse_huge_page(struct mm_struct *mm, unsigned long a
 	enum scan_result result = SCAN_FAIL;
 	struct vm_area_struct *vma;
 	struct mmu_notifier_range range;
+	u64 start = ktime_get_ns();
 
 	VM_BUG_ON(address & ~HPAGE_PMD_MASK);
 
@@ -1226,6 +1297,7 @@ static enum scan_result collapse_huge_page(struct mm_struct *mm, unsigned long a
 out_nolock:
 	if (folio)
 		folio_put(folio);
+	khugepaged_account_collapse(cc, start, result);
 	trace_mm_collapse_huge_page(mm, result == SCAN_SUCCEED, result);
 	return result;
 }
@@ -1858,6 +1930,7 @@ static enum scan_result collapse_file(struct mm_struct *mm, unsigned long addr,
 	enum scan_result result = SCAN_SUCCEED;
 	int nr_none = 0;
 	bool is_shmem = shmem_file(file);
+	u64 collapse_start = ktime_get_ns();
 
 	VM_BUG_ON(!IS_ENABLED(CONFIG_READ_ONLY_THP_FOR_FS) && !is_shmem);
 	VM_BUG_ON(start & (HPAGE_PMD_NR - 1));
@@ -2275,6 +2348,7 @@ static enum scan_result collapse_file(struct mm_struct *mm, unsigned long addr,
 	folio_put(new_folio);
 out:
 	VM_BUG_ON(!list_empty(&pagelist));
+	khugepaged_account_collapse(cc, collapse_start, result);
 	trace_mm_khugepaged_collapse_file(mm, new_folio, index, addr, is_shmem, file, HPAGE_PMD_NR, result);
 	return result;
 }
@@ -2385,6 +2459,59 @@ static enum scan_result hpage_collapse_scan_file(struct mm_struct *mm, unsigned
 	return result;
 }
 
+/*
+ * Look at the PMD ranges the fault path recently populated before resuming
+ * the linear walk, so that fresh regions of a large mm do not have to wait
+ * for a full pass of the scan cursor. Takes and drops mmap_lock itself.
+ */
+static unsigned int khugepaged_scan_hints(struct mm_struct *mm,
+					  enum scan_result *result,
+					  struct collapse_control *cc)
+{
+	struct vm_area_struct *vma;
+	bool mmap_locked = false;
+	unsigned int progress = 0;
+	int i;
+
+	for (i = 0; i < MM_KHUGEPAGED_HINTS; i++) {
+		unsigned long addr;
+
+		if (!READ_ONCE(mm->khugepaged_hints[i]))
+			continue;
+		addr = xchg(&mm->khugepaged_hints[i], 0);
+		if (!addr)
+			continue;
+
+		if (!mmap_locked) {
+			if (!mmap_read_trylock(mm))
+				break;
+			mmap_locked = true;
+		}
+		if (unlikely(hpage_collapse_test_exit_or_disable(mm)))
+			break;
+
+		progress++;
+		vma = vma_lookup(mm, addr);
+		if (!vma || !vma_is_anonymous(vma) ||
+		    addr < round_up(vma->vm_start, HPAGE_PMD_SIZE) ||
+		    addr + HPAGE_PMD_SIZE > round_down(vma->vm_end, HPAGE_PMD_SIZE) ||
+		    !thp_vma_allowable_order(vma, vma->vm_flags, TVA_KHUGEPAGED, PMD_ORDER))
+			continue;
+
+		*result = hpage_collapse_scan_pmd(mm, vma, addr, &mmap_locked, cc);
+		if (*result == SCAN_SUCCEED) {
+			++khugepaged_pages_collapsed;
+			++khugepaged_hint_pages_collapsed;
+		}
+		progress += HPAGE_PMD_NR;
+		cond_resched();
+	}
+
+	if (mmap_locked)
+		mmap_read_unlock(mm);
+	return progress;
+}
+
 static unsigned int khugepaged_scan_mm_slot(unsigned int pages, enum scan_result *result,
 					    struct collapse_control *cc)
 	__releases(&khugepaged_mm_lock)
@@ -2411,6 +2538,13 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, enum scan_result
 	spin_unlock(&khugepaged_mm_lock);
 
 	mm = slot->mm;
+	progress = khugepaged_scan_hints(mm, result, cc);
+	if (*result == SCAN_ALLOC_HUGE_PAGE_FAIL) {
+		/* Let khugepaged_do_scan() back off; keep the slot. */
+		spin_lock(&khugepaged_mm_lock);
+		return max(progress, 1);
+	}
+
 	/*
 	 * Don't wait for semaphore (to avoid long wait times).  Just move to
 	 * the next mm on the list.
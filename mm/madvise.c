@@ -1648,9 +1648,11 @@ static bool try_vma_read_lock(struct madvise_behavior *madv_behavior)
 	}
 
 	madv_behavior->vma = vma;
+	count_vm_vma_lock_event(MADVISE_VMA_LOCK_SUCCESS);
 	return true;
 
 take_mmap_read_lock:
+	count_vm_vma_lock_event(MADVISE_VMA_LOCK_FALLBACK);
 	mmap_read_lock(mm);
 	madv_behavior->lock_mode = MADVISE_MMAP_READ_LOCK;
 	return false;
@@ -53,6 +53,7 @@
 #include <linux/memremap.h>
 #include <linux/kmsan.h>
 #include <linux/ksm.h>
+#include <linux/khugepaged.h>
 #include <linux/rmap.h>
 #include <linux/export.h>
 #include <linux/delayacct.h>
@@ -4543,7 +4544,7 @@ static struct folio *__alloc_swap_folio(struct vm_fault *vmf)
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 /*
  * Check if the PTEs within a range are contiguous swap entries
- * and have consistent swapcache, zeromap.
+ * and have consistent swapcache, zeromap and zswap.
  */
 static bool can_swapin_thp(struct vm_fault *vmf, pte_t *ptep, int nr_pages)
 {
@@ -4571,6 +4572,14 @@ static bool can_swapin_thp(struct vm_fault *vmf, pte_t *ptep, int nr_pages)
 		return false;
 	if (unlikely(non_swapcache_batch(entry, nr_pages) != nr_pages))
 		return false;
+	/*
+	 * A large swapped out folio could be partially or fully in zswap, and
+	 * zswap writeback could make it partially so before the folio is added
+	 * to the swap cache. Only the range being entirely outside of zswap is
+	 * stable, as no new zswap entries can be stored for it.
+	 */
+	if (zswap_present_test(entry, nr_pages))
+		return false;
 
 	return true;
 }
@@ -4617,14 +4626,6 @@ static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 	if (unlikely(userfaultfd_armed(vma)))
 		goto fallback;
 
-	/*
-	 * A large swapped out folio could be partially or fully in zswap. We
-	 * lack handling for such cases, so fallback to swapping in order-0
-	 * folio.
-	 */
-	if (!zswap_never_enabled())
-		goto fallback;
-
 	entry = softleaf_from_pte(vmf->orig_pte);
 	/*
 	 * Get a list of all the (large) orders below PMD_ORDER that are enabled
@@ -6415,15 +6416,18 @@ static vm_fault_t __handle_mm_fault(struct vm_area_struct *vma,
 	if (pmd_none(*vmf.pmd) &&
 	    thp_vma_allowable_order(vma, vm_flags, TVA_PAGEFAULT, PMD_ORDER)) {
 		ret = create_huge_pmd(&vmf);
-		if (ret & VM_FAULT_FALLBACK)
+		if (ret & VM_FAULT_FALLBACK) {
+			khugepaged_fault_hint(vma, address);
 			goto fallback;
-		else
-			return ret;
+		}
+		return ret;
 	}
 
 	vmf.orig_pmd = pmdp_get_lockless(vmf.pmd);
-	if (pmd_none(vmf.orig_pmd))
+	if (pmd_none(vmf.orig_pmd)) {
+		khugepaged_fault_hint(vma, address);
 		goto fallback;
+	}
 
 	if (unlikely(!pmd_present(vmf.orig_pmd))) {
 		if (pmd_is_device_private_entry(vmf.orig_pmd))
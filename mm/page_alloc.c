@@ -2581,6 +2581,60 @@ static int rmqueue_bulk(struct zone *zone, unsigned int order,
 	return i;
 }
 
+static int percpu_pagelist_adaptive;
+
+/* Weight of a new sample in the pcp rate EWMA is 1 / 2^PCP_EWMA_SHIFT */
+#define PCP_EWMA_SHIFT		2
+/* Aim for no more than 2^PCP_ADAPTIVE_BATCH_SHIFT zone->lock trips per interval */
+#define PCP_ADAPTIVE_BATCH_SHIFT	6
+
+static inline int pcp_ewma(int avg, int sample)
+{
+	return avg + (sample - avg) / (1 << PCP_EWMA_SHIFT);
+}
+
+/*
+ * Fold the number of pages moved between the pcp lists and the buddy
+ * allocator during the last vmstat interval into the per-cpu rates. With
+ * vm.percpu_pagelist_adaptive enabled, scale pcp->batch so that a bursty
+ * allocator takes zone->lock fewer times, and return the rate based floor
+ * that pcp->high should not decay below. Otherwise return high_min.
+ */
+static int pcp_adapt_high_batch(struct zone *zone, struct per_cpu_pages *pcp,
+				int high_min, int *batchp)
+{
+	int high_max, base_batch, max_batch, batch, rate;
+	unsigned long UP_flags;
+
+	pcp_spin_lock_maybe_irqsave(pcp, UP_flags);
+	pcp->alloc_rate = pcp_ewma(pcp->alloc_rate, pcp->nr_alloc);
+	pcp->free_rate = pcp_ewma(pcp->free_rate, pcp->nr_free);
+	pcp->nr_alloc = 0;
+	pcp->nr_free = 0;
+	pcp_spin_unlock_maybe_irqrestore(pcp, UP_flags);
+
+	if (!READ_ONCE(percpu_pagelist_adaptive))
+		return high_min;
+
+	/* PCP disabled, boot pageset, or high tuned manually */
+	high_max = READ_ONCE(pcp->high_max);
+	base_batch = READ_ONCE(zone->pageset_batch);
+	if (high_max < base_batch || high_min == high_max)
+		return high_min;
+
+	rate = max(pcp->alloc_rate, pcp->free_rate);
+
+	/* Keep at least 4 batches worth of room below high_max */
+	max_batch = max(min(base_batch << CONFIG_PCP_BATCH_SCALE_MAX,
+			    high_max / 4), base_batch);
+	batch = clamp(rate >> PCP_ADAPTIVE_BATCH_SHIFT, base_batch, max_batch);
+	WRITE_ONCE(pcp->batch, batch);
+	*batchp = batch;
+
+	/* Enough room to absorb one interval worth of buddy traffic */
+	return clamp(rate, high_min, high_max);
+}
+
 /*
  * Called from the vmstat counter updater to decay the PCP high.
  * Return whether there are addition works to do.
@@ -2593,6 +2647,9 @@ bool decay_pcp_high(struct zone *zone, struct per_cpu_pages *pcp)
 
 	high_min = READ_ONCE(pcp->high_min);
 	batch = READ_ONCE(pcp->batch);
+	high_min = pcp_adapt_high_batch(zone, pcp, high_min, &batch);
+	if (pcp->high < high_min)
+		pcp->high = high_min;
 	/*
 	 * Decrease pcp->high periodically to try to free possible
 	 * idle PCP pages.  And, avoid to free too many pages to
@@ -2910,6 +2967,7 @@ static bool free_frozen_page_commit(struct zone *zone,
 		return true;
 
 	to_free = nr_pcp_free(pcp, batch, high, free_high);
+	pcp->nr_free += to_free;
 	while (to_free > 0 && pcp->count > 0) {
 		to_free_batched = min(to_free, batch);
 		free_pcppages_bulk(zone, to_free_batched, pcp, pindex);
@@ -3351,6 +3409,7 @@ struct page *__rmqueue_pcplist(struct zone *zone, unsigned int order,
 					migratetype, alloc_flags);
 
 			pcp->count += alloced << order;
+			pcp->nr_alloc += alloced << order;
 			if (unlikely(list_empty(list)))
 				return NULL;
 		}
@@ -6740,6 +6799,35 @@ static int percpu_pagelist_high_fraction_sysctl_handler(const struct ctl_table *
 	return ret;
 }
 
+/*
+ * percpu_pagelist_adaptive - when enabled, pcp->batch and the floor of
+ * pcp->high for each zone on each cpu follow the rate at which pages are moved
+ * between the per cpu pagelists and the buddy allocator.
+ */
+static int percpu_pagelist_adaptive_sysctl_handler(const struct ctl_table *table,
+		int write, void *buffer, size_t *length, loff_t *ppos)
+{
+	struct zone *zone;
+	int ret;
+
+	if (!write)
+		return proc_dointvec_minmax(table, write, buffer, length, ppos);
+
+	mutex_lock(&pcp_batch_high_lock);
+	ret = proc_dointvec_minmax(table, write, buffer, length, ppos);
+	if (ret < 0 || percpu_pagelist_adaptive)
+		goto out;
+
+	/* Restore the static batch on all cpus */
+	for_each_populated_zone(zone)
+		__zone_set_pageset_high_and_batch(zone, zone->pageset_high_min,
+						  zone->pageset_high_max,
+						  zone->pageset_batch);
+out:
+	mutex_unlock(&pcp_batch_high_lock);
+	return ret;
+}
+
 static const struct ctl_table page_alloc_sysctl_table[] = {
 	{
 		.procname	= "min_free_kbytes",
@@ -6783,6 +6871,15 @@ static const struct ctl_table page_alloc_sysctl_table[] = {
 		.proc_handler	= percpu_pagelist_high_fraction_sysctl_handler,
 		.extra1		= SYSCTL_ZERO,
 	},
+	{
+		.procname	= "percpu_pagelist_adaptive",
+		.data		= &percpu_pagelist_adaptive,
+		.maxlen		= sizeof(percpu_pagelist_adaptive),
+		.mode		= 0644,
+		.proc_handler	= percpu_pagelist_adaptive_sysctl_handler,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= SYSCTL_ONE,
+	},
 	{
 		.procname	= "lowmem_reserve_ratio",
 		.data		= &sysctl_lowmem_reserve_ratio,
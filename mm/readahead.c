@@ -128,6 +128,7 @@
 #include <linux/blk-cgroup.h>
 #include <linux/fadvise.h>
 #include <linux/sched/mm.h>
+#include <linux/seq_file.h>
 
 #define CREATE_TRACE_POINTS
 #include <trace/events/readahead.h>
@@ -146,6 +147,84 @@ file_ra_state_init(struct file_ra_state *ra, struct address_space *mapping)
 }
 EXPORT_SYMBOL_GPL(file_ra_state_init);
 
+/*
+ * Access pattern classification kept in file_ra_state->pattern.  The low
+ * nibble holds the pattern, the high nibble how many consecutive reads
+ * matched it.  The confidence scales how far ahead we read for patterns
+ * other than sequential, which has its own ramp-up in get_next_ra_size().
+ */
+enum ra_pattern {
+	RA_PATTERN_SEQUENTIAL,
+	RA_PATTERN_STRIDED,
+	RA_PATTERN_RANDOM,
+	RA_PATTERN_REVERSE,
+};
+
+#define RA_PATTERN_MASK		0x0f
+#define RA_CONFIDENCE_SHIFT	4
+#define RA_CONFIDENCE_MAX	3U
+
+static const char * const ra_pattern_names[] = {
+	[RA_PATTERN_SEQUENTIAL]	= "sequential",
+	[RA_PATTERN_STRIDED]	= "strided",
+	[RA_PATTERN_RANDOM]	= "random",
+	[RA_PATTERN_REVERSE]	= "reverse",
+};
+
+static inline enum ra_pattern ra_pattern(struct file_ra_state *ra)
+{
+	return ra->pattern & RA_PATTERN_MASK;
+}
+
+static inline unsigned int ra_confidence(struct file_ra_state *ra)
+{
+	return ra->pattern >> RA_CONFIDENCE_SHIFT;
+}
+
+static void ra_set_pattern(struct file_ra_state *ra, enum ra_pattern pattern)
+{
+	unsigned int conf = 0;
+
+	if (ra_pattern(ra) == pattern)
+		conf = min(ra_confidence(ra) + 1, RA_CONFIDENCE_MAX);
+	ra->pattern = pattern | (conf << RA_CONFIDENCE_SHIFT);
+}
+
+#ifdef CONFIG_READAHEAD_STATS
+static inline void ra_stat_pages(struct readahead_control *ractl,
+				 unsigned int order)
+{
+	struct file_ra_state *ra = ractl->ra;
+
+	if (!ra)
+		return;
+	ra->nr_pages += 1UL << order;
+	if (order)
+		ra->nr_large_pages += 1UL << order;
+}
+#define ra_stat_inc(ra, item)	((ra)->item++)
+#else
+static inline void ra_stat_pages(struct readahead_control *ractl,
+				 unsigned int order)
+{
+}
+#define ra_stat_inc(ra, item)	do { } while (0)
+#endif
+
+void file_ra_show_fdinfo(struct seq_file *m, struct file *file)
+{
+	struct file_ra_state *ra = &file->f_ra;
+
+	seq_printf(m, "ra_pattern:\t%s\nra_order:\t%u\nra_window:\t%u\n",
+		   ra_pattern_names[ra_pattern(ra)], READ_ONCE(ra->order),
+		   READ_ONCE(ra->size));
+#ifdef CONFIG_READAHEAD_STATS
+	seq_printf(m, "ra_sync:\t%u\nra_async:\t%u\nra_pages:\t%lu\nra_large_pages:\t%lu\n",
+		   READ_ONCE(ra->nr_sync), READ_ONCE(ra->nr_async),
+		   READ_ONCE(ra->nr_pages), READ_ONCE(ra->nr_large_pages));
+#endif
+}
+
 static void read_pages(struct readahead_control *rac)
 {
 	const struct address_space_operations *aops = rac->mapping->a_ops;
@@ -293,6 +372,7 @@ void page_cache_ra_unbounded(struct readahead_control *ractl,
 			folio_set_readahead(folio);
 		ractl->_workingset |= folio_test_workingset(folio);
 		ractl->_nr_pages += min_nrpages;
+		ra_stat_pages(ractl, mapping_min_folio_order(mapping));
 		i += min_nrpages;
 	}
 
@@ -461,6 +541,7 @@ static inline int ra_alloc_folio(struct readahead_control *ractl, pgoff_t index,
 
 	ractl->_nr_pages += 1UL << order;
 	ractl->_workingset |= folio_test_workingset(folio);
+	ra_stat_pages(ractl, order);
 	return 0;
 }
 
@@ -554,6 +635,96 @@ static unsigned long ractl_max_pages(struct readahead_control *ractl,
 	return max_pages;
 }
 
+/*
+ * Read @nr pages at @start into folios of up to @order, as one readahead
+ * window without an async marker.
+ */
+static void ra_read_window(struct readahead_control *ractl,
+		struct file_ra_state *ra, pgoff_t start, unsigned long nr,
+		unsigned int order)
+{
+	ra->start = start;
+	ra->size = nr;
+	ra->async_size = 0;
+	ra->order = order;
+	ractl->_index = start;
+	page_cache_ra_order(ractl, ra);
+}
+
+/*
+ * A read that does not continue a sequential stream.  Decide whether it is
+ * part of a strided or reverse scan, or just random, and read accordingly.
+ *
+ * Like the sequential detection this looks for the traces a pattern leaves
+ * in the page cache: for a stride S, the previous record, which ended at
+ * ra->prev_pos, and the one S before it should both be cached.
+ *
+ * Only the pattern byte of @ra is updated.  The reads are issued through a
+ * window private to this call, so that a sequential stream interleaved with
+ * these reads keeps its readahead state, as it did when non-sequential reads
+ * bypassed the window altogether.
+ */
+static void page_cache_ra_nonseq(struct readahead_control *ractl,
+		unsigned long req_count, unsigned long max_pages)
+{
+	struct file_ra_state *ra = ractl->ra;
+	struct file_ra_state window = { .ra_pages = ra->ra_pages };
+	pgoff_t index = readahead_index(ractl);
+	pgoff_t prev_index = (unsigned long long)ra->prev_pos >> PAGE_SHIFT;
+	enum ra_pattern pattern = RA_PATTERN_RANDOM;
+	unsigned int order = req_count > 1 ? ilog2(req_count) : 0;
+	unsigned long stride = 0;
+	pgoff_t prev_start;
+	struct folio *folio;
+
+	if (ra->prev_pos >= 0 && index < prev_index &&
+	    prev_index - index < 2 * req_count) {
+		pattern = RA_PATTERN_REVERSE;
+	} else if (ra->prev_pos >= 0 && index > prev_index + 1 &&
+		   prev_index + 1 >= req_count) {
+		/* Assume the previous record was as large as this one */
+		prev_start = prev_index + 1 - req_count;
+		stride = index - prev_start;
+		if (stride <= max_pages * 8 && prev_start >= stride) {
+			rcu_read_lock();
+			folio = xa_load(&ractl->mapping->i_pages,
+					prev_start - stride);
+			rcu_read_unlock();
+			if (folio && !xa_is_value(folio))
+				pattern = RA_PATTERN_STRIDED;
+		}
+	}
+	ra_set_pattern(ra, pattern);
+
+	switch (pattern) {
+	case RA_PATTERN_STRIDED: {
+		unsigned long nr_records, i;
+
+		/* The record being read, plus 1 to 8 upcoming ones */
+		nr_records = 1 + (1UL << ra_confidence(ra));
+		nr_records = clamp(max_pages / req_count, 1UL, nr_records);
+		for (i = 0; i < nr_records; i++)
+			ra_read_window(ractl, &window, index + i * stride,
+				       req_count, order);
+		break;
+	}
+	case RA_PATTERN_REVERSE: {
+		unsigned long nr = min(req_count << (ra_confidence(ra) + 1),
+				       max_pages);
+		pgoff_t end = index + req_count;
+
+		/* Read backwards: the window ends where this request does */
+		nr = min_t(unsigned long, nr, end);
+		ra_read_window(ractl, &window, end - nr, nr, order);
+		break;
+	}
+	default:
+		/* Read as is, at order-0, and do not set up a window */
+		do_page_cache_ra(ractl, req_count, 0);
+		break;
+	}
+}
+
 void page_cache_sync_ra(struct readahead_control *ractl,
 		unsigned long req_count)
 {
@@ -583,6 +754,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 		return;
 	}
 
+	ra_stat_inc(ra, nr_sync);
 	max_pages = ractl_max_pages(ractl, req_count);
 	prev_index = (unsigned long long)ra->prev_pos >> PAGE_SHIFT;
 	/*
@@ -591,6 +763,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	 * unaligned reads: (index - prev_index) == 0
 	 */
 	if (!index || req_count > max_pages || index - prev_index <= 1UL) {
+		ra_set_pattern(ra, RA_PATTERN_SEQUENTIAL);
 		ra->start = index;
 		ra->size = get_init_ra_size(req_count, max_pages);
 		ra->async_size = ra->size > req_count ? ra->size - req_count :
@@ -607,11 +780,11 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	rcu_read_unlock();
 	contig_count = index - miss - 1;
 	/*
-	 * Standalone, small random read. Read as is, and do not pollute the
-	 * readahead state.
+	 * No sequential history in front of this read: classify it as
+	 * strided, reverse, or a standalone random read.
 	 */
 	if (contig_count <= req_count) {
-		do_page_cache_ra(ractl, req_count, 0);
+		page_cache_ra_nonseq(ractl, req_count, max_pages);
 		return;
 	}
 	/*
@@ -620,6 +793,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	 */
 	if (miss == ULONG_MAX)
 		contig_count *= 2;
+	ra_set_pattern(ra, RA_PATTERN_SEQUENTIAL);
 	ra->start = index;
 	ra->size = min(contig_count + req_count, max_pages);
 	ra->async_size = 1;
@@ -654,6 +828,8 @@ void page_cache_async_ra(struct readahead_control *ractl,
 	if (blk_cgroup_congested())
 		return;
 
+	ra_stat_inc(ra, nr_async);
+	ra_set_pattern(ra, RA_PATTERN_SEQUENTIAL);
 	max_pages = ractl_max_pages(ractl, req_count);
 	/*
 	 * It's the expected callback index, assume sequential access.
@@ -163,7 +163,9 @@
  *
  * SLUB assigns two object arrays called sheaves for caching allocations and
  * frees on each cpu, with a NUMA node shared barn for balancing between cpus.
- * Allocations and frees are primarily served from these sheaves.
+ * Allocations and frees are primarily served from these sheaves. Frees of
+ * objects from a remote node are batched in a separate percpu sheaf that is
+ * handed over to the remote node's barn when full.
  *
  * Slabs with free elements are kept on a partial list and during regular
  * operations no list for full slabs is used. If an object in a full slab is
@@ -362,6 +364,10 @@ enum stat_item {
 	SHEAF_PREFILL_OVERSIZE,	/* Allocation of oversize sheaf for prefill */
 	SHEAF_RETURN_FAST,	/* Sheaf return reattached spare sheaf */
 	SHEAF_RETURN_SLOW,	/* Sheaf return could not reattach spare */
+	SHEAF_REMOTE_FREE,	/* Free to a remote node sheaf */
+	SHEAF_REMOTE_FREE_FAIL,	/* Failed to free to a remote node sheaf */
+	SHEAF_REMOTE_PUT,	/* Put remote sheaf to its node's barn */
+	SHEAF_REMOTE_FLUSH,	/* Objects flushed from a remote sheaf */
 	NR_SLUB_STAT_ITEMS
 };
 
@@ -413,7 +419,7 @@ struct slab_sheaf {
 	};
 	struct kmem_cache *cache;
 	unsigned int size;
-	int node; /* only used for rcu_sheaf */
+	int node; /* only used for rcu_sheaf and remote sheaf */
 	void *objects[];
 };
 
@@ -422,6 +428,7 @@ struct slub_percpu_sheaves {
 	struct slab_sheaf *main; /* never NULL when unlocked */
 	struct slab_sheaf *spare; /* empty or full, may be NULL */
 	struct slab_sheaf *rcu_free; /* for batching kfree_rcu() */
+	struct slab_sheaf *remote; /* for batching frees of remote objects */
 };
 
 /*
@@ -2992,7 +2999,7 @@ static void rcu_free_sheaf_nobarn(struct rcu_head *head)
 static void pcs_flush_all(struct kmem_cache *s)
 {
 	struct slub_percpu_sheaves *pcs;
-	struct slab_sheaf *spare, *rcu_free;
+	struct slab_sheaf *spare, *rcu_free, *remote;
 
 	local_lock(&s->cpu_sheaves->lock);
 	pcs = this_cpu_ptr(s->cpu_sheaves);
@@ -3003,6 +3010,9 @@ static void pcs_flush_all(struct kmem_cache *s)
 	rcu_free = pcs->rcu_free;
 	pcs->rcu_free = NULL;
 
+	remote = pcs->remote;
+	pcs->remote = NULL;
+
 	local_unlock(&s->cpu_sheaves->lock);
 
 	if (spare) {
@@ -3010,6 +3020,11 @@ static void pcs_flush_all(struct kmem_cache *s)
 		free_empty_sheaf(s, spare);
 	}
 
+	if (remote) {
+		sheaf_flush_unused(s, remote);
+		free_empty_sheaf(s, remote);
+	}
+
 	if (rcu_free)
 		call_rcu(&rcu_free->rcu_head, rcu_free_sheaf_nobarn);
 
@@ -3030,6 +3045,12 @@ static void __pcs_flush_all_cpu(struct kmem_cache *s, unsigned int cpu)
 		pcs->spare = NULL;
 	}
 
+	if (pcs->remote) {
+		sheaf_flush_unused(s, pcs->remote);
+		free_empty_sheaf(s, pcs->remote);
+		pcs->remote = NULL;
+	}
+
 	if (pcs->rcu_free) {
 		call_rcu(&pcs->rcu_free->rcu_head, rcu_free_sheaf_nobarn);
 		pcs->rcu_free = NULL;
@@ -3071,6 +3092,7 @@ static void pcs_destroy(struct kmem_cache *s)
 
 		WARN_ON(pcs->spare);
 		WARN_ON(pcs->rcu_free);
+		WARN_ON(pcs->remote);
 
 		if (!WARN_ON(pcs->main->size)) {
 			free_empty_sheaf(s, pcs->main);
@@ -3951,7 +3973,7 @@ static bool has_pcs_used(int cpu, struct kmem_cache *s)
 
 	pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
 
-	return (pcs->spare || pcs->rcu_free || pcs->main->size);
+	return (pcs->spare || pcs->rcu_free || pcs->remote || pcs->main->size);
 }
 
 /*
@@ -5786,6 +5808,118 @@ bool free_to_pcs(struct kmem_cache *s, void *object, bool allow_spin)
 	return true;
 }
 
+/*
+ * Hand over a detached remote sheaf, whose objects all belong to sheaf->node,
+ * to the barn of that node. Cpus local to that node can then allocate the
+ * objects through their percpu sheaves without touching the slab freelists.
+ * If that barn is already full, free the objects to their slabs in bulk.
+ */
+static void remote_sheaf_flush(struct kmem_cache *s, struct slab_sheaf *sheaf)
+{
+	struct kmem_cache_node *n = get_node(s, sheaf->node);
+	struct node_barn *barn;
+
+	if (likely(n && n->barn && sheaf->size) &&
+	    data_race(n->barn->nr_full) < MAX_FULL_SHEAVES) {
+		barn_put_full_sheaf(n->barn, sheaf);
+		stat(s, SHEAF_REMOTE_PUT);
+		return;
+	}
+
+	stat_add(s, SHEAF_REMOTE_FLUSH, sheaf->size);
+	sheaf_flush_unused(s, sheaf);
+
+	barn = get_barn(s);
+	if (barn && data_race(barn->nr_empty) < MAX_EMPTY_SHEAVES) {
+		barn_put_empty_sheaf(barn, sheaf);
+		return;
+	}
+
+	free_empty_sheaf(s, sheaf);
+}
+
+/*
+ * Free an object that belongs to a different node than the current cpu's
+ * closest memory node. Instead of going to __slab_free() for each object and
+ * contending on the remote slab's freelist, batch the objects in a percpu
+ * sheaf dedicated to a single remote node and hand it over to that node's barn
+ * once it fills up, or once we start freeing objects of another node.
+ *
+ * The object is expected to have passed slab_free_hook() already.
+ */
+static bool free_to_pcs_remote(struct kmem_cache *s, void *object, int node)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *remote, *stale = NULL, *full = NULL;
+	bool ret = false;
+
+	if (!local_trylock(&s->cpu_sheaves->lock))
+		goto fail;
+
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	/* Bootstrap or debug cache, fall back */
+	if (unlikely(!cache_has_sheaves(s)))
+		goto unlock;
+
+	remote = pcs->remote;
+
+	if (unlikely(remote && remote->node != node)) {
+		stale = remote;
+		remote = NULL;
+		pcs->remote = NULL;
+	}
+
+	if (unlikely(!remote)) {
+		struct node_barn *barn;
+
+		if (pcs->spare && pcs->spare->size == 0) {
+			remote = pcs->spare;
+			pcs->spare = NULL;
+		} else {
+			barn = get_barn(s);
+			if (barn)
+				remote = barn_get_empty_sheaf(barn, true);
+			if (!remote)
+				goto unlock;
+		}
+
+		remote->node = node;
+		pcs->remote = remote;
+	}
+
+	/*
+	 * Since we detach the sheaf as soon as size reaches capacity, we never
+	 * reach this with size already at capacity, so no OOB write is possible.
+	 */
+	remote->objects[remote->size++] = object;
+
+	if (unlikely(remote->size == s->sheaf_capacity)) {
+		full = remote;
+		pcs->remote = NULL;
+	}
+
+	ret = true;
+
+unlock:
+	local_unlock(&s->cpu_sheaves->lock);
+
+	if (stale)
+		remote_sheaf_flush(s, stale);
+
+	if (full)
+		remote_sheaf_flush(s, full);
+
+	if (ret) {
+		stat(s, SHEAF_REMOTE_FREE);
+		return true;
+	}
+
+fail:
+	stat(s, SHEAF_REMOTE_FREE_FAIL);
+	return false;
+}
+
 static void rcu_free_sheaf(struct rcu_head *head)
 {
 	struct kmem_cache_node *n;
@@ -6169,6 +6303,9 @@ void slab_free(struct kmem_cache *s, struct slab *slab, void *object,
 	    && likely(!slab_test_pfmemalloc(slab))) {
 		if (likely(free_to_pcs(s, object, true)))
 			return;
+	} else if (IS_ENABLED(CONFIG_NUMA) && !slab_test_pfmemalloc(slab)) {
+		if (free_to_pcs_remote(s, object, slab_nid(slab)))
+			return;
 	}
 
 	__slab_free(s, slab, object, object, 1, addr);
@@ -9256,6 +9393,10 @@ STAT_ATTR(SHEAF_PREFILL_SLOW, sheaf_prefill_slow);
 STAT_ATTR(SHEAF_PREFILL_OVERSIZE, sheaf_prefill_oversize);
 STAT_ATTR(SHEAF_RETURN_FAST, sheaf_return_fast);
 STAT_ATTR(SHEAF_RETURN_SLOW, sheaf_return_slow);
+STAT_ATTR(SHEAF_REMOTE_FREE, sheaf_remote_free);
+STAT_ATTR(SHEAF_REMOTE_FREE_FAIL, sheaf_remote_free_fail);
+STAT_ATTR(SHEAF_REMOTE_PUT, sheaf_remote_put);
+STAT_ATTR(SHEAF_REMOTE_FLUSH, sheaf_remote_flush);
 #endif	/* CONFIG_SLUB_STATS */
 
 #ifdef CONFIG_KFENCE
@@ -9344,6 +9485,10 @@ static struct attribute *slab_attrs[] = {
 	&sheaf_prefill_oversize_attr.attr,
 	&sheaf_return_fast_attr.attr,
 	&sheaf_return_slow_attr.attr,
+	&sheaf_remote_free_attr.attr,
+	&sheaf_remote_free_fail_attr.attr,
+	&sheaf_remote_put_attr.attr,
+	&sheaf_remote_flush_attr.attr,
 #endif
 #ifdef CONFIG_FAILSLAB
 	&failslab_attr.attr,
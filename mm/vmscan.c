@@ -5655,6 +5655,202 @@ static const struct file_operations lru_gen_ro_fops = {
 	.release = seq_release,
 };
 
+#ifdef CONFIG_MEMCG
+/******************************************************************************
+ *                          memory.lru_gen
+ ******************************************************************************/
+
+/*
+ * For each node with memory, print "node N" followed by one line per
+ * generation of the memcg from the oldest evictable one to the youngest:
+ * the sequence number, the age in milliseconds, and the number of anon and
+ * file pages in that generation.
+ */
+int lru_gen_memcg_show(struct seq_file *m, struct mem_cgroup *memcg)
+{
+	int nid;
+
+	for_each_node_state(nid, N_MEMORY) {
+		struct lruvec *lruvec = get_lruvec(memcg, nid);
+		struct lru_gen_folio *lrugen = &lruvec->lrugen;
+		unsigned long seq;
+		DEFINE_MAX_SEQ(lruvec);
+		DEFINE_MIN_SEQ(lruvec);
+
+		seq_printf(m, "node %d\n", nid);
+
+		for (seq = evictable_min_seq(min_seq, MAX_SWAPPINESS / 2);
+		     seq <= max_seq; seq++) {
+			int type, zone;
+			int gen = lru_gen_from_seq(seq);
+			unsigned long birth = READ_ONCE(lrugen->timestamps[gen]);
+
+			seq_printf(m, " %10lu %10u", seq,
+				   jiffies_to_msecs(jiffies - birth));
+
+			for (type = 0; type < ANON_AND_FILE; type++) {
+				unsigned long size = 0;
+
+				for (zone = 0; zone < MAX_NR_ZONES; zone++)
+					size += max(READ_ONCE(lrugen->nr_pages[gen][type][zone]), 0L);
+
+				seq_printf(m, " %10lu", size);
+			}
+
+			seq_putc(m, '\n');
+		}
+	}
+
+	return 0;
+}
+
+enum {
+	LRU_GEN_OPT_NODE,
+	LRU_GEN_OPT_SWAPPINESS,
+	LRU_GEN_OPT_SWAPPINESS_MAX,
+	LRU_GEN_OPT_NULL,
+};
+
+static const match_table_t lru_gen_opt_tokens = {
+	{ LRU_GEN_OPT_NODE, "node=%d" },
+	{ LRU_GEN_OPT_SWAPPINESS, "swappiness=%d" },
+	{ LRU_GEN_OPT_SWAPPINESS_MAX, "swappiness=max" },
+	{ LRU_GEN_OPT_NULL, NULL },
+};
+
+static int lru_gen_memcg_run(struct mem_cgroup *memcg, int nid, bool evict,
+			     int swappiness, unsigned long nr_to_reclaim,
+			     unsigned long *nr_reclaimed, struct scan_control *sc)
+{
+	struct lruvec *lruvec = get_lruvec(memcg, nid);
+	DEFINE_MAX_SEQ(lruvec);
+	int err;
+
+	if (swappiness < MIN_SWAPPINESS)
+		swappiness = get_swappiness(lruvec, sc);
+
+	if (!evict)
+		return run_aging(lruvec, max_seq, swappiness, true);
+
+	/* evict everything but the MIN_NR_GENS youngest generations */
+	if (max_seq < MIN_NR_GENS)
+		return 0;
+
+	err = run_eviction(lruvec, max_seq - MIN_NR_GENS, sc, swappiness,
+			   nr_to_reclaim - *nr_reclaimed);
+	*nr_reclaimed += sc->nr_reclaimed;
+
+	return err;
+}
+
+/*
+ * Accept one of the following commands:
+ *
+ *   age [node=N] [swappiness=N|max]
+ *   evict NR_PAGES [node=N] [swappiness=N|max]
+ *
+ * "age" creates a new youngest generation after scanning the page tables of
+ * the memcg, and "evict" reclaims up to NR_PAGES pages from the generations
+ * older than the MIN_NR_GENS youngest ones. Without node=, the command is run
+ * on all nodes with memory, in order.
+ */
+int lru_gen_memcg_write(char *buf, struct mem_cgroup *memcg)
+{
+	unsigned long nr_to_reclaim = 0, nr_reclaimed = 0;
+	substring_t args[MAX_OPT_ARGS];
+	int nid = NUMA_NO_NODE;
+	int swappiness = -1;
+	unsigned int flags;
+	struct blk_plug plug;
+	char *cmd, *start;
+	bool evict;
+	int err = 0;
+	struct scan_control sc = {
+		.may_writepage = true,
+		.may_unmap = true,
+		.may_swap = true,
+		.reclaim_idx = MAX_NR_ZONES - 1,
+		.gfp_mask = GFP_KERNEL,
+		.proactive = true,
+		.target_mem_cgroup = memcg,
+	};
+
+	if (!lru_gen_enabled())
+		return -EOPNOTSUPP;
+
+	buf = strstrip(buf);
+	cmd = strsep(&buf, " ");
+
+	if (!strcmp(cmd, "age")) {
+		evict = false;
+	} else if (!strcmp(cmd, "evict")) {
+		evict = true;
+		start = strsep(&buf, " ");
+		if (!start || kstrtoul(start, 0, &nr_to_reclaim) || !nr_to_reclaim)
+			return -EINVAL;
+	} else {
+		return -EINVAL;
+	}
+
+	while ((start = strsep(&buf, " ")) != NULL) {
+		if (!strlen(start))
+			continue;
+		switch (match_token(start, lru_gen_opt_tokens, args)) {
+		case LRU_GEN_OPT_NODE:
+			if (match_int(&args[0], &nid))
+				return -EINVAL;
+			if (nid < 0 || nid >= MAX_NUMNODES ||
+			    !node_state(nid, N_MEMORY))
+				return -EINVAL;
+			break;
+		case LRU_GEN_OPT_SWAPPINESS:
+			if (match_int(&args[0], &swappiness))
+				return -EINVAL;
+			if (swappiness < MIN_SWAPPINESS ||
+			    swappiness > MAX_SWAPPINESS)
+				return -EINVAL;
+			break;
+		case LRU_GEN_OPT_SWAPPINESS_MAX:
+			swappiness = SWAPPINESS_ANON_ONLY;
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	set_task_reclaim_state(current, &sc.reclaim_state);
+	flags = memalloc_noreclaim_save();
+	blk_start_plug(&plug);
+	if (!set_mm_walk(NULL, true)) {
+		err = -ENOMEM;
+		goto done;
+	}
+
+	if (nid != NUMA_NO_NODE) {
+		err = lru_gen_memcg_run(memcg, nid, evict, swappiness,
+					nr_to_reclaim, &nr_reclaimed, &sc);
+		goto done;
+	}
+
+	for_each_node_state(nid, N_MEMORY) {
+		err = lru_gen_memcg_run(memcg, nid, evict, swappiness,
+					nr_to_reclaim, &nr_reclaimed, &sc);
+		/* another aging of this node got there first */
+		if (err == -EEXIST)
+			err = 0;
+		if (err || (evict && nr_reclaimed >= nr_to_reclaim))
+			break;
+	}
+done:
+	clear_mm_walk();
+	blk_finish_plug(&plug);
+	memalloc_noreclaim_restore(flags);
+	set_task_reclaim_state(current, NULL);
+
+	return err;
+}
+#endif /* CONFIG_MEMCG */
+
 /******************************************************************************
  *                          initialization
  ******************************************************************************/
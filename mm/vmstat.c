@@ -1461,6 +1461,8 @@ const char * const vmstat_text[] = {
 	[I(VMA_LOCK_ABORT)]			= "vma_lock_abort",
 	[I(VMA_LOCK_RETRY)]			= "vma_lock_retry",
 	[I(VMA_LOCK_MISS)]			= "vma_lock_miss",
+	[I(MADVISE_VMA_LOCK_SUCCESS)]		= "madvise_vma_lock_success",
+	[I(MADVISE_VMA_LOCK_FALLBACK)]		= "madvise_vma_lock_fallback",
 #endif
 #ifdef CONFIG_DEBUG_STACK_USAGE
 	[I(KSTACK_1K)]				= "kstack_1k",
@@ -1822,13 +1824,17 @@ static void zoneinfo_show_print(struct seq_file *m, pg_data_t *pgdat,
 			   "\n              high:     %i"
 			   "\n              batch:    %i"
 			   "\n              high_min: %i"
-			   "\n              high_max: %i",
+			   "\n              high_max: %i"
+			   "\n              alloc_rate: %i"
+			   "\n              free_rate:  %i",
 			   i,
 			   pcp->count,
 			   pcp->high,
 			   pcp->batch,
 			   pcp->high_min,
-			   pcp->high_max);
+			   pcp->high_max,
+			   pcp->alloc_rate,
+			   pcp->free_rate);
 #ifdef CONFIG_SMP
 		pzstats = per_cpu_ptr(zone->per_cpu_zonestats, i);
 		seq_printf(m, "\n  vm stats threshold: %d",
@@ -136,11 +136,23 @@ bool zswap_never_enabled(void)
 * data structures
 **********************************/
 
+/* Maximum number of pages submitted to the compressor before waiting */
+#define ZSWAP_MAX_BATCH_SIZE	8U
+
+/*
+ * Asynchronous compressors get ZSWAP_MAX_BATCH_SIZE requests, each with its own
+ * buffer, so that the pages of a large folio can be (de)compressed in parallel.
+ * Synchronous compressors would just process them one by one so they only get
+ * a single request.
+ */
 struct crypto_acomp_ctx {
 	struct crypto_acomp *acomp;
-	struct acomp_req *req;
-	struct crypto_wait wait;
-	u8 *buffer;
+	unsigned int nr_reqs;
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH_SIZE];
+	struct crypto_wait waits[ZSWAP_MAX_BATCH_SIZE];
+	u8 *buffers[ZSWAP_MAX_BATCH_SIZE];
+	struct scatterlist inputs[ZSWAP_MAX_BATCH_SIZE];
+	struct scatterlist outputs[ZSWAP_MAX_BATCH_SIZE];
 	struct mutex mutex;
 };
 
@@ -736,17 +748,12 @@ static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 {
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH_SIZE] = { NULL };
+	u8 *buffers[ZSWAP_MAX_BATCH_SIZE] = { NULL };
 	struct crypto_acomp *acomp = NULL;
-	struct acomp_req *req = NULL;
-	u8 *buffer = NULL;
+	unsigned int i, nr_reqs;
 	int ret;
 
-	buffer = kmalloc_node(PAGE_SIZE, GFP_KERNEL, cpu_to_node(cpu));
-	if (!buffer) {
-		ret = -ENOMEM;
-		goto fail;
-	}
-
 	acomp = crypto_alloc_acomp_node(pool->tfm_name, 0, 0, cpu_to_node(cpu));
 	if (IS_ERR(acomp)) {
 		pr_err("could not alloc crypto acomp %s : %pe\n",
@@ -755,12 +762,22 @@ static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 		goto fail;
 	}
 
-	req = acomp_request_alloc(acomp);
-	if (!req) {
-		pr_err("could not alloc crypto acomp_request %s\n",
-		       pool->tfm_name);
-		ret = -ENOMEM;
-		goto fail;
+	nr_reqs = acomp_is_async(acomp) ? ZSWAP_MAX_BATCH_SIZE : 1;
+
+	for (i = 0; i < nr_reqs; i++) {
+		buffers[i] = kmalloc_node(PAGE_SIZE, GFP_KERNEL, cpu_to_node(cpu));
+		if (!buffers[i]) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		reqs[i] = acomp_request_alloc(acomp);
+		if (!reqs[i]) {
+			pr_err("could not alloc crypto acomp_request %s\n",
+			       pool->tfm_name);
+			ret = -ENOMEM;
+			goto fail;
+		}
 	}
 
 	/*
@@ -769,26 +786,36 @@ static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 	 * again resulting in a deadlock.
 	 */
 	mutex_lock(&acomp_ctx->mutex);
-	crypto_init_wait(&acomp_ctx->wait);
 
-	/*
-	 * if the backend of acomp is async zip, crypto_req_done() will wakeup
-	 * crypto_wait_req(); if the backend of acomp is scomp, the callback
-	 * won't be called, crypto_wait_req() will return without blocking.
-	 */
-	acomp_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG,
-				   crypto_req_done, &acomp_ctx->wait);
+	for (i = 0; i < nr_reqs; i++) {
+		crypto_init_wait(&acomp_ctx->waits[i]);
+
+		/*
+		 * if the backend of acomp is async zip, crypto_req_done() will
+		 * wakeup crypto_wait_req(); if the backend of acomp is scomp,
+		 * the callback won't be called, crypto_wait_req() will return
+		 * without blocking.
+		 */
+		acomp_request_set_callback(reqs[i], CRYPTO_TFM_REQ_MAY_BACKLOG,
+					   crypto_req_done, &acomp_ctx->waits[i]);
+
+		acomp_ctx->buffers[i] = buffers[i];
+		acomp_ctx->reqs[i] = reqs[i];
+	}
 
-	acomp_ctx->buffer = buffer;
 	acomp_ctx->acomp = acomp;
-	acomp_ctx->req = req;
+	acomp_ctx->nr_reqs = nr_reqs;
 	mutex_unlock(&acomp_ctx->mutex);
 	return 0;
 
 fail:
+	for (i = 0; i < ZSWAP_MAX_BATCH_SIZE; i++) {
+		if (reqs[i])
+			acomp_request_free(reqs[i]);
+		kfree(buffers[i]);
+	}
 	if (!IS_ERR_OR_NULL(acomp))
 		crypto_free_acomp(acomp);
-	kfree(buffer);
 	return ret;
 }
 
@@ -796,31 +823,38 @@ static int zswap_cpu_comp_dead(unsigned int cpu, struct hlist_node *node)
 {
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
-	struct acomp_req *req;
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH_SIZE];
+	u8 *buffers[ZSWAP_MAX_BATCH_SIZE];
 	struct crypto_acomp *acomp;
-	u8 *buffer;
+	unsigned int i, nr_reqs;
 
 	if (IS_ERR_OR_NULL(acomp_ctx))
 		return 0;
 
 	mutex_lock(&acomp_ctx->mutex);
-	req = acomp_ctx->req;
+	nr_reqs = acomp_ctx->nr_reqs;
+	for (i = 0; i < nr_reqs; i++) {
+		reqs[i] = acomp_ctx->reqs[i];
+		buffers[i] = acomp_ctx->buffers[i];
+		acomp_ctx->reqs[i] = NULL;
+		acomp_ctx->buffers[i] = NULL;
+	}
 	acomp = acomp_ctx->acomp;
-	buffer = acomp_ctx->buffer;
-	acomp_ctx->req = NULL;
 	acomp_ctx->acomp = NULL;
-	acomp_ctx->buffer = NULL;
+	acomp_ctx->nr_reqs = 0;
 	mutex_unlock(&acomp_ctx->mutex);
 
 	/*
 	 * Do the actual freeing after releasing the mutex to avoid subtle
 	 * locking dependencies causing deadlocks.
 	 */
-	if (!IS_ERR_OR_NULL(req))
-		acomp_request_free(req);
+	for (i = 0; i < nr_reqs; i++) {
+		if (!IS_ERR_OR_NULL(reqs[i]))
+			acomp_request_free(reqs[i]);
+		kfree(buffers[i]);
+	}
 	if (!IS_ERR_OR_NULL(acomp))
 		crypto_free_acomp(acomp);
-	kfree(buffer);
 
 	return 0;
 }
@@ -832,14 +866,15 @@ static struct crypto_acomp_ctx *acomp_ctx_get_cpu_lock(struct zswap_pool *pool)
 	for (;;) {
 		acomp_ctx = raw_cpu_ptr(pool->acomp_ctx);
 		mutex_lock(&acomp_ctx->mutex);
-		if (likely(acomp_ctx->req))
+		if (likely(acomp_ctx->nr_reqs))
 			return acomp_ctx;
 		/*
 		 * It is possible that we were migrated to a different CPU after
 		 * getting the per-CPU ctx but before the mutex was acquired. If
 		 * the old CPU got offlined, zswap_cpu_comp_dead() could have
-		 * already freed ctx->req (among other things) and set it to
-		 * NULL. Just try again on the new CPU that we ended up on.
+		 * already freed ctx->reqs (among other things) and set
+		 * ctx->nr_reqs to 0. Just try again on the new CPU that we ended
+		 * up on.
 		 */
 		mutex_unlock(&acomp_ctx->mutex);
 	}
@@ -850,41 +885,19 @@ static void acomp_ctx_put_unlock(struct crypto_acomp_ctx *acomp_ctx)
 	mutex_unlock(&acomp_ctx->mutex);
 }
 
-static bool zswap_compress(struct page *page, struct zswap_entry *entry,
-			   struct zswap_pool *pool)
+/*
+ * Store the result of compressing page into dst in a zsmalloc allocation
+ * referenced by entry.
+ */
+static bool zswap_compress_store(struct page *page, struct zswap_entry *entry,
+				 struct zswap_pool *pool, u8 *dst,
+				 unsigned int dlen, int comp_ret)
 {
-	struct crypto_acomp_ctx *acomp_ctx;
-	struct scatterlist input, output;
-	int comp_ret = 0, alloc_ret = 0;
-	unsigned int dlen = PAGE_SIZE;
+	int alloc_ret = 0;
 	unsigned long handle;
 	gfp_t gfp;
-	u8 *dst;
 	bool mapped = false;
 
-	acomp_ctx = acomp_ctx_get_cpu_lock(pool);
-	dst = acomp_ctx->buffer;
-	sg_init_table(&input, 1);
-	sg_set_page(&input, page, PAGE_SIZE, 0);
-
-	sg_init_one(&output, dst, PAGE_SIZE);
-	acomp_request_set_params(acomp_ctx->req, &input, &output, PAGE_SIZE, dlen);
-
-	/*
-	 * it maybe looks a little bit silly that we send an asynchronous request,
-	 * then wait for its completion synchronously. This makes the process look
-	 * synchronous in fact.
-	 * Theoretically, acomp supports users send multiple acomp requests in one
-	 * acomp instance, then get those requests done simultaneously. but in this
-	 * case, zswap actually does store and load page by page, there is no
-	 * existing method to send the second page before the first page is done
-	 * in one thread doing zswap.
-	 * but in different threads running on different cpu, we have different
-	 * acomp instance, so multiple threads can do (de)compression in parallel.
-	 */
-	comp_ret = crypto_wait_req(crypto_acomp_compress(acomp_ctx->req), &acomp_ctx->wait);
-	dlen = acomp_ctx->req->dlen;
-
 	/*
 	 * If a page cannot be compressed into a size smaller than PAGE_SIZE,
 	 * save the content as is without a compression, to keep the LRU order
@@ -896,7 +909,7 @@ static bool zswap_compress(struct page *page, struct zswap_entry *entry,
 		if (!mem_cgroup_zswap_writeback_enabled(
 					folio_memcg(page_folio(page)))) {
 			comp_ret = comp_ret ? comp_ret : -EINVAL;
-			goto unlock;
+			goto out;
 		}
 		comp_ret = 0;
 		dlen = PAGE_SIZE;
@@ -908,14 +921,14 @@ static bool zswap_compress(struct page *page, struct zswap_entry *entry,
 	handle = zs_malloc(pool->zs_pool, dlen, gfp, page_to_nid(page));
 	if (IS_ERR_VALUE(handle)) {
 		alloc_ret = PTR_ERR((void *)handle);
-		goto unlock;
+		goto out;
 	}
 
 	zs_obj_write(pool->zs_pool, handle, dst, dlen);
 	entry->handle = handle;
 	entry->length = dlen;
 
-unlock:
+out:
 	if (mapped)
 		kunmap_local(dst);
 	if (comp_ret == -ENOSPC || alloc_ret == -ENOSPC)
@@ -925,10 +938,76 @@ static bool zswap_compress(struct page *page, struct zswap_entry *entry,
 	else if (alloc_ret)
 		zswap_reject_alloc_fail++;
 
-	acomp_ctx_put_unlock(acomp_ctx);
 	return comp_ret == 0 && alloc_ret == 0;
 }
 
+/*
+ * Compress nr_pages pages of folio starting at index, one zswap entry per page.
+ *
+ * Up to acomp_ctx->nr_reqs pages are submitted to the compressor before we
+ * wait for any of them to complete. An asynchronous compressor can then work
+ * on them in parallel, while a synchronous one completes each request at
+ * submission, in which case this degenerates to compressing page by page.
+ *
+ * On failure, entries that got a zsmalloc handle still own it.
+ */
+static bool zswap_compress(struct folio *folio, long index,
+			   unsigned int nr_pages, struct zswap_entry **entries,
+			   struct zswap_pool *pool)
+{
+	int errs[ZSWAP_MAX_BATCH_SIZE];
+	struct crypto_acomp_ctx *acomp_ctx;
+	unsigned int i, j, batch;
+	bool ret = true;
+
+	acomp_ctx = acomp_ctx_get_cpu_lock(pool);
+
+	for (i = 0; ret && i < nr_pages; i += batch) {
+		batch = min(nr_pages - i, acomp_ctx->nr_reqs);
+
+		for (j = 0; j < batch; j++) {
+			struct page *page = folio_page(folio, index + i + j);
+
+			sg_init_table(&acomp_ctx->inputs[j], 1);
+			sg_set_page(&acomp_ctx->inputs[j], page, PAGE_SIZE, 0);
+			sg_init_one(&acomp_ctx->outputs[j],
+				    acomp_ctx->buffers[j], PAGE_SIZE);
+			acomp_request_set_params(acomp_ctx->reqs[j],
+						 &acomp_ctx->inputs[j],
+						 &acomp_ctx->outputs[j],
+						 PAGE_SIZE, PAGE_SIZE);
+			errs[j] = crypto_acomp_compress(acomp_ctx->reqs[j]);
+		}
+
+		for (j = 0; j < batch; j++)
+			errs[j] = crypto_wait_req(errs[j], &acomp_ctx->waits[j]);
+
+		for (j = 0; j < batch; j++) {
+			if (!zswap_compress_store(folio_page(folio, index + i + j),
+						  entries[i + j], pool,
+						  acomp_ctx->buffers[j],
+						  acomp_ctx->reqs[j]->dlen,
+						  errs[j])) {
+				ret = false;
+				break;
+			}
+		}
+	}
+
+	acomp_ctx_put_unlock(acomp_ctx);
+	return ret;
+}
+
+static void zswap_decompress_fail_report(struct zswap_entry *entry, int dlen)
+{
+	zswap_decompress_fail++;
+	pr_alert_ratelimited("Decompression error from zswap (%d:%lu %s %u->%d)\n",
+						swp_type(entry->swpentry),
+						swp_offset(entry->swpentry),
+						entry->pool->tfm_name,
+						entry->length, dlen);
+}
+
 static bool zswap_decompress(struct zswap_entry *entry, struct folio *folio)
 {
 	struct zswap_pool *pool = entry->pool;
@@ -954,11 +1033,11 @@ static bool zswap_decompress(struct zswap_entry *entry, struct folio *folio)
 	} else {
 		sg_init_table(&output, 1);
 		sg_set_folio(&output, folio, PAGE_SIZE, 0);
-		acomp_request_set_params(acomp_ctx->req, input, &output,
+		acomp_request_set_params(acomp_ctx->reqs[0], input, &output,
 					 entry->length, PAGE_SIZE);
-		ret = crypto_acomp_decompress(acomp_ctx->req);
-		ret = crypto_wait_req(ret, &acomp_ctx->wait);
-		dlen = acomp_ctx->req->dlen;
+		ret = crypto_acomp_decompress(acomp_ctx->reqs[0]);
+		ret = crypto_wait_req(ret, &acomp_ctx->waits[0]);
+		dlen = acomp_ctx->reqs[0]->dlen;
 	}
 
 	zs_obj_read_sg_end(pool->zs_pool, entry->handle);
@@ -967,12 +1046,7 @@ static bool zswap_decompress(struct zswap_entry *entry, struct folio *folio)
 	if (!ret && dlen == PAGE_SIZE)
 		return true;
 
-	zswap_decompress_fail++;
-	pr_alert_ratelimited("Decompression error from zswap (%d:%lu %s %u->%d)\n",
-						swp_type(entry->swpentry),
-						swp_offset(entry->swpentry),
-						entry->pool->tfm_name,
-						entry->length, dlen);
+	zswap_decompress_fail_report(entry, dlen);
 	return false;
 }
 
@@ -1405,83 +1479,127 @@ static void shrink_worker(struct work_struct *w)
 * main API
 **********************************/
 
-static bool zswap_store_page(struct page *page,
-			     struct obj_cgroup *objcg,
-			     struct zswap_pool *pool)
+/*
+ * Compress and store nr_pages pages of folio starting at index. All the pages
+ * of a folio belong to the same tree, so the entries of the batch are stored
+ * under a single tree lock acquisition.
+ */
+static bool zswap_store_pages(struct folio *folio, long index,
+			      unsigned int nr_pages, struct obj_cgroup *objcg,
+			      struct zswap_pool *pool)
 {
-	swp_entry_t page_swpentry = page_swap_entry(page);
-	struct zswap_entry *entry, *old;
+	struct zswap_entry *entries[ZSWAP_MAX_BATCH_SIZE];
+	struct zswap_entry *olds[ZSWAP_MAX_BATCH_SIZE] = { NULL };
+	swp_entry_t swp = page_swap_entry(folio_page(folio, index));
+	pgoff_t offset = swp_offset(swp);
+	XA_STATE(xas, swap_zswap_tree(swp), offset);
+	unsigned int i, nr_alloced;
+	int err;
 
-	/* allocate entry */
-	entry = zswap_entry_cache_alloc(GFP_KERNEL, page_to_nid(page));
-	if (!entry) {
-		zswap_reject_kmemcache_fail++;
-		return false;
+	/* allocate entries */
+	for (nr_alloced = 0; nr_alloced < nr_pages; nr_alloced++) {
+		struct zswap_entry *entry;
+
+		entry = zswap_entry_cache_alloc(GFP_KERNEL, folio_nid(folio));
+		if (!entry) {
+			zswap_reject_kmemcache_fail++;
+			goto free_entries;
+		}
+		entry->handle = 0;
+		entries[nr_alloced] = entry;
 	}
 
-	if (!zswap_compress(page, entry, pool))
-		goto compress_failed;
+	if (!zswap_compress(folio, index, nr_pages, entries, pool))
+		goto free_entries;
 
-	old = xa_store(swap_zswap_tree(page_swpentry),
-		       swp_offset(page_swpentry),
-		       entry, GFP_KERNEL);
-	if (xa_is_err(old)) {
-		int err = xa_err(old);
+	do {
+		xas_lock(&xas);
+		for (i = 0; i < nr_pages; i++) {
+			struct zswap_entry *old;
 
-		WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
-		zswap_reject_alloc_fail++;
-		goto store_failed;
-	}
+			xas_set(&xas, offset + i);
+			old = xas_store(&xas, entries[i]);
+			if (xas_error(&xas))
+				break;
+			/* seen already if we had to retry due to -ENOMEM */
+			if (old && old != entries[i])
+				olds[i] = old;
+		}
+		xas_unlock(&xas);
+	} while (xas_nomem(&xas, GFP_KERNEL));
 
 	/*
-	 * We may have had an existing entry that became stale when
-	 * the folio was redirtied and now the new version is being
-	 * swapped out. Get rid of the old.
+	 * We may have had existing entries that became stale when the folio
+	 * was redirtied and now the new version is being swapped out. Get rid
+	 * of the old ones.
 	 */
-	if (old)
-		zswap_entry_free(old);
+	for (i = 0; i < nr_pages; i++)
+		if (olds[i])
+			zswap_entry_free(olds[i]);
 
-	/*
-	 * The entry is successfully compressed and stored in the tree, there is
-	 * no further possibility of failure. Grab refs to the pool and objcg,
-	 * charge zswap memory, and increment zswap_stored_pages.
-	 * The opposite actions will be performed by zswap_entry_free()
-	 * when the entry is removed from the tree.
-	 */
-	zswap_pool_get(pool);
-	if (objcg) {
-		obj_cgroup_get(objcg);
-		obj_cgroup_charge_zswap(objcg, entry->length);
+	err = xas_error(&xas);
+	if (err) {
+		WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
+		zswap_reject_alloc_fail++;
+
+		xas_lock(&xas);
+		for (i = 0; i < nr_pages; i++) {
+			xas_set(&xas, offset + i);
+			if (xas_load(&xas) == entries[i])
+				xas_store(&xas, NULL);
+		}
+		xas_unlock(&xas);
+		goto free_entries;
 	}
-	atomic_long_inc(&zswap_stored_pages);
-	if (entry->length == PAGE_SIZE)
-		atomic_long_inc(&zswap_stored_incompressible_pages);
 
-	/*
-	 * We finish initializing the entry while it's already in xarray.
-	 * This is safe because:
-	 *
-	 * 1. Concurrent stores and invalidations are excluded by folio lock.
-	 *
-	 * 2. Writeback is excluded by the entry not being on the LRU yet.
-	 *    The publishing order matters to prevent writeback from seeing
-	 *    an incoherent entry.
-	 */
-	entry->pool = pool;
-	entry->swpentry = page_swpentry;
-	entry->objcg = objcg;
-	entry->referenced = true;
-	if (entry->length) {
-		INIT_LIST_HEAD(&entry->lru);
-		zswap_lru_add(&zswap_list_lru, entry);
+	for (i = 0; i < nr_pages; i++) {
+		struct zswap_entry *entry = entries[i];
+
+		/*
+		 * The entry is successfully compressed and stored in the tree,
+		 * there is no further possibility of failure. Grab refs to the
+		 * pool and objcg, charge zswap memory, and increment
+		 * zswap_stored_pages. The opposite actions will be performed by
+		 * zswap_entry_free() when the entry is removed from the tree.
+		 */
+		zswap_pool_get(pool);
+		if (objcg) {
+			obj_cgroup_get(objcg);
+			obj_cgroup_charge_zswap(objcg, entry->length);
+		}
+		atomic_long_inc(&zswap_stored_pages);
+		if (entry->length == PAGE_SIZE)
+			atomic_long_inc(&zswap_stored_incompressible_pages);
+
+		/*
+		 * We finish initializing the entry while it's already in
+		 * xarray. This is safe because:
+		 *
+		 * 1. Concurrent stores and invalidations are excluded by folio
+		 *    lock.
+		 *
+		 * 2. Writeback is excluded by the entry not being on the LRU
+		 *    yet. The publishing order matters to prevent writeback
+		 *    from seeing an incoherent entry.
+		 */
+		entry->pool = pool;
+		entry->swpentry = swp_entry(swp_type(swp), offset + i);
+		entry->objcg = objcg;
+		entry->referenced = true;
+		if (entry->length) {
+			INIT_LIST_HEAD(&entry->lru);
+			zswap_lru_add(&zswap_list_lru, entry);
+		}
 	}
 
 	return true;
 
-store_failed:
-	zs_free(pool->zs_pool, entry->handle);
-compress_failed:
-	zswap_entry_cache_free(entry);
+free_entries:
+	for (i = 0; i < nr_alloced; i++) {
+		if (entries[i]->handle)
+			zs_free(pool->zs_pool, entries[i]->handle);
+		zswap_entry_cache_free(entries[i]);
+	}
 	return false;
 }
 
@@ -1527,10 +1645,11 @@ bool zswap_store(struct folio *folio)
 		mem_cgroup_put(memcg);
 	}
 
-	for (index = 0; index < nr_pages; ++index) {
-		struct page *page = folio_page(folio, index);
+	for (index = 0; index < nr_pages; index += ZSWAP_MAX_BATCH_SIZE) {
+		unsigned int nr = min_t(long, nr_pages - index,
+					ZSWAP_MAX_BATCH_SIZE);
 
-		if (!zswap_store_page(page, objcg, pool))
+		if (!zswap_store_pages(folio, index, nr, objcg, pool))
 			goto put_pool;
 	}
 
@@ -1571,6 +1690,41 @@ bool zswap_store(struct folio *folio)
 	return ret;
 }
 
+/**
+ * zswap_present_test() - check if any of a range of swap entries is in zswap
+ * @swp: first swap entry of the range
+ * @nr_pages: number of swap entries in the range
+ *
+ * Swapping in a large folio is only supported if none or all of its pages are
+ * in zswap. Callers use this before allocating the swap cache folio, when
+ * only the former is stable: no new entry can be stored for swap slots that
+ * are not in the swap cache, while writeback may remove entries at any time.
+ *
+ * Return: true if at least one of the swap entries is stored in zswap.
+ */
+bool zswap_present_test(swp_entry_t swp, int nr_pages)
+{
+	struct xarray *tree = swap_zswap_tree(swp);
+	pgoff_t offset = swp_offset(swp);
+	XA_STATE(xas, tree, offset);
+	struct zswap_entry *entry;
+	bool ret = false;
+
+	if (zswap_never_enabled())
+		return false;
+
+	rcu_read_lock();
+	xas_for_each(&xas, entry, offset + nr_pages - 1) {
+		if (xas_retry(&xas, entry))
+			continue;
+		ret = true;
+		break;
+	}
+	rcu_read_unlock();
+
+	return ret;
+}
+
 /**
  * zswap_load() - load a folio from zswap
  * @folio: folio to load
@@ -1583,10 +1737,10 @@ bool zswap_store(struct folio *folio)
  *  NOT marked up-to-date, so that an IO error is emitted (e.g. do_swap_page()
  *  will SIGBUS).
  *
- *  -EINVAL: if the swapped out content was in zswap, but the page belongs
- *  to a large folio, which is not supported by zswap. The folio is unlocked,
- *  but NOT marked up-to-date, so that an IO error is emitted (e.g.
- *  do_swap_page() will SIGBUS).
+ *  -EINVAL: if the folio is large and any of the swapped out content was in
+ *  zswap, which is not supported. The folio is unlocked, but NOT
+ *  marked up-to-date, so that an IO error is emitted (e.g. do_swap_page()
+ *  will SIGBUS).
  *
  *  -ENOENT: if the swapped out content was not in zswap. The folio remains
  *  locked on return.
@@ -1605,13 +1759,17 @@ int zswap_load(struct folio *folio)
 		return -ENOENT;
 
 	/*
-	 * Large folios should not be swapped in while zswap is being used, as
-	 * they are not properly handled. Zswap does not properly load large
-	 * folios, and a large folio may only be partially in zswap.
+	 * Large folios are only swapped in when none of their range is in
+	 * zswap, see can_swapin_thp(). Zswap does not load large folios, and
+	 * may only hold part of one.
 	 */
-	if (WARN_ON_ONCE(folio_test_large(folio))) {
-		folio_unlock(folio);
-		return -EINVAL;
+	if (folio_test_large(folio)) {
+		if (WARN_ON_ONCE(zswap_present_test(swp,
+						    folio_nr_pages(folio)))) {
+			folio_unlock(folio);
+			return -EINVAL;
+		}
+		return -ENOENT;
 	}
 
 	entry = xa_load(tree, offset);
@@ -4924,6 +4924,87 @@ int __dev_direct_xmit(struct sk_buff *skb, u16 queue_id)
 }
 EXPORT_SYMBOL(__dev_direct_xmit);
 
+/**
+ * __dev_direct_xmit_list - transmit a list of skbs bypassing the qdisc layer
+ * @skb: skbs chained through skb->next, all for the same device
+ * @queue_id: tx queue to transmit on
+ * @ret: status of the last transmit attempt
+ *
+ * Like __dev_direct_xmit(), but the whole list is handed to the driver under
+ * a single HARD_TX_LOCK, with xmit_more set on all but the last skb. Skbs
+ * failing validation, or replaced by it, are dropped. Returns the skbs the
+ * driver did not accept, which are still owned by the caller, or NULL.
+ */
+struct sk_buff *__dev_direct_xmit_list(struct sk_buff *skb, u16 queue_id,
+				       int *ret)
+{
+	struct net_device *dev = skb->dev;
+	struct sk_buff *head = NULL, **tail = &head;
+	struct sk_buff *next, *nskb;
+	struct netdev_queue *txq;
+	bool again = false;
+	int rc = NETDEV_TX_OK;
+
+	if (unlikely(!netif_running(dev) ||
+		     !netif_carrier_ok(dev))) {
+		dev_core_stats_tx_dropped_inc(dev);
+		kfree_skb_list(skb);
+		*ret = NET_XMIT_DROP;
+		return NULL;
+	}
+
+	for (; skb; skb = next) {
+		next = skb->next;
+		skb_mark_not_on_list(skb);
+
+		/* As in __dev_direct_xmit(), drop skbs that validation had to
+		 * segment or reallocate.
+		 */
+		nskb = validate_xmit_skb(skb, dev, &again);
+		if (unlikely(nskb != skb)) {
+			if (nskb) {
+				dev_core_stats_tx_dropped_inc(dev);
+				kfree_skb_list(nskb);
+			}
+			continue;
+		}
+
+		skb_set_queue_mapping(skb, queue_id);
+		*tail = skb;
+		tail = &skb->next;
+	}
+
+	skb = head;
+	if (!skb) {
+		*ret = NET_XMIT_DROP;
+		return NULL;
+	}
+
+	txq = netdev_get_tx_queue(dev, queue_id);
+
+	local_bh_disable();
+
+	dev_xmit_recursion_inc();
+	HARD_TX_LOCK(dev, txq, smp_processor_id());
+	while (skb && !netif_xmit_frozen_or_drv_stopped(txq)) {
+		struct sk_buff *next = skb->next;
+
+		skb_mark_not_on_list(skb);
+		rc = netdev_start_xmit(skb, dev, txq, next != NULL);
+		if (unlikely(!dev_xmit_complete(rc))) {
+			skb->next = next;
+			break;
+		}
+		skb = next;
+	}
+	HARD_TX_UNLOCK(dev, txq);
+	dev_xmit_recursion_dec();
+
+	local_bh_enable();
+	*ret = skb ? NETDEV_TX_BUSY : rc;
+	return skb;
+}
+
 /*************************************************************************
  *			Receiver routines
  *************************************************************************/
@@ -5287,6 +5368,7 @@ void kick_defer_list_purge(unsigned int cpu)
 		backlog_unlock_irq_restore(sd, flags);
 
 	} else if (!cmpxchg(&sd->defer_ipi_scheduled, 0, 1)) {
+		this_cpu_inc(softnet_data.defer_ipis);
 		smp_call_function_single_async(cpu, &sd->defer_csd);
 	}
 }
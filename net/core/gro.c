@@ -287,11 +287,32 @@ static void gro_complete(struct gro_node *gro, struct sk_buff *skb)
 	gro_normal_one(gro, skb, NAPI_GRO_CB(skb)->count);
 }
 
+/* A bucket seeing less than two skbs per flush on average has little to
+ * merge its held packets with, keeping them past a flush only adds latency.
+ */
+#define GRO_SPARSE_RATE		(2 << 3)
+
+static void gro_list_update_rate(struct gro_node *gro, u32 index)
+{
+	struct gro_list *gro_list = &gro->hash[index];
+	u32 rate = gro_list->rate;
+
+	rate = rate - (rate >> 3) + gro_list->seen;
+	gro_list->rate = min(rate, U16_MAX);
+	gro_list->seen = 0;
+
+	if (!gro_list->rate)
+		__clear_bit(index, &gro->rate_mask);
+}
+
 static void __gro_flush_chain(struct gro_node *gro, u32 index, bool flush_old)
 {
 	struct list_head *head = &gro->hash[index].list;
 	struct sk_buff *skb, *p;
 
+	if (gro->hash[index].rate < GRO_SPARSE_RATE)
+		flush_old = false;
+
 	list_for_each_entry_safe_reverse(skb, p, head, list) {
 		if (flush_old && NAPI_GRO_CB(skb)->age == jiffies)
 			return;
@@ -311,9 +332,21 @@ static void __gro_flush_chain(struct gro_node *gro, u32 index, bool flush_old)
  */
 void __gro_flush(struct gro_node *gro, bool flush_old)
 {
-	unsigned long bitmask = gro->bitmask;
+	unsigned long bitmask = gro->rate_mask;
 	unsigned int i, base = ~0U;
 
+	/* Close the flush interval of every bucket that saw traffic, not
+	 * only of those still holding packets, so that the rates decay in
+	 * polls that leave a bucket empty.
+	 */
+	while ((i = ffs(bitmask)) != 0) {
+		bitmask >>= i;
+		base += i;
+		gro_list_update_rate(gro, base);
+	}
+
+	bitmask = gro->bitmask;
+	base = ~0U;
 	while ((i = ffs(bitmask)) != 0) {
 		bitmask >>= i;
 		base += i;
@@ -474,6 +507,9 @@ static enum gro_result dev_gro_receive(struct gro_node *gro,
 	if (netif_elide_gro(skb->dev))
 		goto normal;
 
+	if (gro_list->seen < U16_MAX)
+		gro_list->seen++;
+	__set_bit(bucket, &gro->rate_mask);
 	gro_list_prepare(&gro_list->list, skb);
 
 	rcu_read_lock();
@@ -805,10 +841,13 @@ void gro_init(struct gro_node *gro)
 	for (u32 i = 0; i < GRO_HASH_BUCKETS; i++) {
 		INIT_LIST_HEAD(&gro->hash[i].list);
 		gro->hash[i].count = 0;
+		gro->hash[i].seen = 0;
+		gro->hash[i].rate = 0;
 	}
 
 	gro->bitmask = 0;
 	gro->cached_napi_id = 0;
+	gro->rate_mask = 0;
 
 	INIT_LIST_HEAD(&gro->rx_list);
 	gro->rx_count = 0;
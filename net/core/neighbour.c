@@ -1005,6 +1005,14 @@ static void neigh_periodic_work(struct work_struct *work)
 		neigh_for_each_in_bucket_safe(n, tmp, &nht->hash_heads[i]) {
 			unsigned int state;
 
+			/*
+			 * Entries in a timer or pinned are never collected
+			 * here, so skip them without dirtying n->lock. The
+			 * state is rechecked under the lock below.
+			 */
+			if (READ_ONCE(n->nud_state) & (NUD_PERMANENT | NUD_IN_TIMER))
+				continue;
+
 			write_lock(&n->lock);
 
 			state = n->nud_state;
@@ -144,7 +144,7 @@ static int softnet_seq_show(struct seq_file *seq, void *v)
 	 */
 	seq_printf(seq,
 		   "%08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x "
-		   "%08x %08x\n",
+		   "%08x %08x %08x %08x\n",
 		   READ_ONCE(sd->processed),
 		   numa_drop_read(&sd->drop_counters),
 		   READ_ONCE(sd->time_squeeze), 0,
@@ -152,7 +152,8 @@ static int softnet_seq_show(struct seq_file *seq, void *v)
 		   0,	/* was cpu_collision */
 		   READ_ONCE(sd->received_rps), flow_limit_count,
 		   input_qlen + process_qlen, (int)seq->index,
-		   input_qlen, process_qlen);
+		   input_qlen, process_qlen,
+		   READ_ONCE(sd->defer_drops), READ_ONCE(sd->defer_ipis));
 	return 0;
 }
 
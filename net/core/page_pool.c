@@ -69,6 +69,8 @@ static const char pp_stats[][ETH_GSTRING_LEN] = {
 	"rx_pp_recycle_ring",
 	"rx_pp_recycle_ring_full",
 	"rx_pp_recycle_released_ref",
+	"rx_pp_recycle_sheaf",
+	"rx_pp_recycle_sheaf_flush",
 };
 
 /**
@@ -107,6 +109,8 @@ bool page_pool_get_stats(const struct page_pool *pool,
 		stats->recycle_stats.ring += pcpu->ring;
 		stats->recycle_stats.ring_full += pcpu->ring_full;
 		stats->recycle_stats.released_refcnt += pcpu->released_refcnt;
+		stats->recycle_stats.sheaf += pcpu->sheaf;
+		stats->recycle_stats.sheaf_flush += pcpu->sheaf_flush;
 	}
 
 	return true;
@@ -147,6 +151,8 @@ u64 *page_pool_ethtool_stats_get(u64 *data, const void *stats)
 	*data++ = pool_stats->recycle_stats.ring;
 	*data++ = pool_stats->recycle_stats.ring_full;
 	*data++ = pool_stats->recycle_stats.released_refcnt;
+	*data++ = pool_stats->recycle_stats.sheaf;
+	*data++ = pool_stats->recycle_stats.sheaf_flush;
 
 	return data;
 }
@@ -196,7 +202,7 @@ static int page_pool_init(struct page_pool *pool,
 {
 	unsigned int ring_qsize = 1024; /* Default */
 	struct netdev_rx_queue *rxq;
-	int err;
+	int err, cpu;
 
 	page_pool_struct_check();
 
@@ -267,6 +273,17 @@ static int page_pool_init(struct page_pool *pool,
 		return -ENOMEM;
 	}
 
+	if (pool->slow.flags & PP_FLAG_PERCPU_RECYCLE) {
+		pool->sheaf = alloc_percpu(struct pp_recycle_sheaf);
+		if (!pool->sheaf ||
+		    !zalloc_cpumask_var(&pool->sheaf_pending, GFP_KERNEL)) {
+			err = -ENOMEM;
+			goto free_ptr_ring;
+		}
+		for_each_possible_cpu(cpu)
+			spin_lock_init(&per_cpu_ptr(pool->sheaf, cpu)->lock);
+	}
+
 	atomic_set(&pool->pages_state_release_cnt, 0);
 
 	/* Driver calling page_pool_create() also call page_pool_destroy() */
@@ -310,6 +327,8 @@ static int page_pool_init(struct page_pool *pool,
 
 free_ptr_ring:
 	ptr_ring_cleanup(&pool->ring, NULL);
+	free_cpumask_var(pool->sheaf_pending);
+	free_percpu(pool->sheaf);
 	xa_destroy(&pool->dma_mapped);
 #ifdef CONFIG_PAGE_POOL_STATS
 	if (!pool->system)
@@ -321,6 +340,8 @@ static int page_pool_init(struct page_pool *pool,
 static void page_pool_uninit(struct page_pool *pool)
 {
 	ptr_ring_cleanup(&pool->ring, NULL);
+	free_cpumask_var(pool->sheaf_pending);
+	free_percpu(pool->sheaf);
 	xa_destroy(&pool->dma_mapped);
 
 #ifdef CONFIG_PAGE_POOL_STATS
@@ -374,6 +395,7 @@ struct page_pool *page_pool_create(const struct page_pool_params *params)
 EXPORT_SYMBOL(page_pool_create);
 
 static void page_pool_return_netmem(struct page_pool *pool, netmem_ref netmem);
+static bool page_pool_flush_sheaves(struct page_pool *pool);
 
 static noinline netmem_ref page_pool_refill_alloc_cache(struct page_pool *pool)
 {
@@ -381,8 +403,11 @@ static noinline netmem_ref page_pool_refill_alloc_cache(struct page_pool *pool)
 	netmem_ref netmem;
 	int pref_nid; /* preferred NUMA node */
 
-	/* Quicker fallback, avoid locks when ring is empty */
-	if (__ptr_ring_empty(r)) {
+	/* Quicker fallback, avoid locks when ring is empty, unless pages
+	 * staged in the per-cpu sheaves can refill it.
+	 */
+	if (__ptr_ring_empty(r) &&
+	    !(pool->sheaf && page_pool_flush_sheaves(pool))) {
 		alloc_stat_inc(pool, empty);
 		return 0;
 	}
@@ -896,6 +921,85 @@ static bool page_pool_napi_local(const struct page_pool *pool)
 	return napi && READ_ONCE(napi->list_owner) == cpuid;
 }
 
+static void page_pool_recycle_ring_bulk(struct page_pool *pool,
+					netmem_ref *bulk,
+					u32 bulk_len);
+
+/* Called with sheaf->lock held */
+static void page_pool_flush_sheaf(struct page_pool *pool,
+				  struct pp_recycle_sheaf *sheaf)
+{
+	page_pool_recycle_ring_bulk(pool, sheaf->netmems, sheaf->count);
+	recycle_stat_inc(pool, sheaf_flush);
+	WRITE_ONCE(sheaf->count, 0);
+}
+
+/* Stage a page that could not be recycled directly in this CPU's sheaf,
+ * flushing the sheaf into the ptr_ring in bulk once it fills up. Any
+ * context on the CPU may use the sheaf, BH disabling keeps us on it.
+ */
+static bool page_pool_recycle_in_sheaf(struct page_pool *pool,
+				       netmem_ref netmem)
+{
+	struct pp_recycle_sheaf *sheaf;
+	bool ret = false;
+
+	local_bh_disable();
+	/* Paired with WRITE_ONCE() in page_pool_drain_sheaves() */
+	if (unlikely(READ_ONCE(pool->sheaf_disabled)))
+		goto out;
+
+	sheaf = this_cpu_ptr(pool->sheaf);
+	spin_lock(&sheaf->lock);
+	/* Left set by flushes on this CPU, cleared by the sweep only */
+	if (!sheaf->count &&
+	    !cpumask_test_cpu(smp_processor_id(), pool->sheaf_pending))
+		cpumask_set_cpu(smp_processor_id(), pool->sheaf_pending);
+	sheaf->netmems[sheaf->count] = netmem;
+	WRITE_ONCE(sheaf->count, sheaf->count + 1);
+	recycle_stat_inc(pool, sheaf);
+
+	if (unlikely(sheaf->count == PP_RECYCLE_SHEAF_SIZE))
+		page_pool_flush_sheaf(pool, sheaf);
+	spin_unlock(&sheaf->lock);
+	ret = true;
+out:
+	local_bh_enable();
+
+	return ret;
+}
+
+/* The ptr_ring ran dry: pull whatever the other CPUs have staged into it
+ * rather than leave up to nr_cpu_ids * (PP_RECYCLE_SHEAF_SIZE - 1) pages
+ * idle while the pool allocates fresh ones. Only CPUs in sheaf_pending are
+ * visited, so the walk is bounded by the CPUs that recycled into the pool
+ * since the last sweep, not by nr_cpu_ids. Sheaves being used right now
+ * are skipped, their owner is about to flush or refill them anyway.
+ *
+ * Returns true if anything was moved into the ptr_ring.
+ */
+static bool page_pool_flush_sheaves(struct page_pool *pool)
+{
+	bool flushed = false;
+	int cpu;
+
+	for_each_cpu(cpu, pool->sheaf_pending) {
+		struct pp_recycle_sheaf *sheaf = per_cpu_ptr(pool->sheaf, cpu);
+
+		if (!spin_trylock_bh(&sheaf->lock))
+			continue;
+
+		if (sheaf->count) {
+			page_pool_flush_sheaf(pool, sheaf);
+			flushed = true;
+		}
+		cpumask_clear_cpu(cpu, pool->sheaf_pending);
+		spin_unlock_bh(&sheaf->lock);
+	}
+
+	return flushed;
+}
+
 void page_pool_put_unrefed_netmem(struct page_pool *pool, netmem_ref netmem,
 				  unsigned int dma_sync_size, bool allow_direct)
 {
@@ -904,7 +1008,13 @@ void page_pool_put_unrefed_netmem(struct page_pool *pool, netmem_ref netmem,
 
 	netmem = __page_pool_put_page(pool, netmem, dma_sync_size,
 				      allow_direct);
-	if (netmem && !page_pool_recycle_in_ring(pool, netmem)) {
+	if (!netmem)
+		return;
+
+	if (pool->sheaf && page_pool_recycle_in_sheaf(pool, netmem))
+		return;
+
+	if (!page_pool_recycle_in_ring(pool, netmem)) {
 		/* Cache full, fallback to free pages */
 		recycle_stat_inc(pool, ring_full);
 		page_pool_return_netmem(pool, netmem);
@@ -1286,6 +1396,36 @@ void page_pool_disable_direct_recycling(struct page_pool *pool)
 }
 EXPORT_SYMBOL(page_pool_disable_direct_recycling);
 
+/* Stop new returns from being staged in the per-cpu sheaves and move
+ * whatever is still staged into the ptr_ring, so that page_pool_scrub()
+ * can see it.
+ */
+static void page_pool_drain_sheaves(struct page_pool *pool)
+{
+	int cpu;
+
+	if (!pool->sheaf)
+		return;
+
+	/* Paired with READ_ONCE() in page_pool_recycle_in_sheaf(). The
+	 * BH-disabled sections using the sheaves are RCU read-side critical
+	 * sections, so once synchronize_net() returns nobody else can be
+	 * touching them.
+	 */
+	WRITE_ONCE(pool->sheaf_disabled, true);
+	synchronize_net();
+
+	for_each_possible_cpu(cpu) {
+		struct pp_recycle_sheaf *sheaf = per_cpu_ptr(pool->sheaf, cpu);
+
+		if (!sheaf->count)
+			continue;
+
+		page_pool_recycle_ring_bulk(pool, sheaf->netmems, sheaf->count);
+		sheaf->count = 0;
+	}
+}
+
 void page_pool_destroy(struct page_pool *pool)
 {
 	if (!pool)
@@ -1295,6 +1435,7 @@ void page_pool_destroy(struct page_pool *pool)
 		return;
 
 	page_pool_disable_direct_recycling(pool);
+	page_pool_drain_sheaves(pool);
 	page_pool_free_frag(pool);
 
 	if (!page_pool_release(pool))
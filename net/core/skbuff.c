@@ -7267,50 +7267,66 @@ static void kfree_skb_napi_cache(struct sk_buff *skb)
 	local_bh_enable();
 }
 
-/**
- * skb_attempt_defer_free - queue skb for remote freeing
- * @skb: buffer
- *
- * Put @skb in a per-cpu list, using the cpu which
- * allocated the skb/pages to reduce false sharing
- * and memory zone spinlock contention.
+/* Returns the cpu whose defer list @skb should go to, or -1 if it has to
+ * be freed right away.
  */
-void skb_attempt_defer_free(struct sk_buff *skb)
+static int skb_defer_cpu(const struct sk_buff *skb)
 {
-	struct skb_defer_node *sdn;
-	unsigned long defer_count;
-	unsigned int defer_max;
-	bool kick;
 	int cpu;
 
 	/* zero copy notifications should not be delayed. */
 	if (skb_zcopy(skb))
-		goto nodefer;
+		return -1;
 
 	cpu = skb->alloc_cpu;
 	if (cpu == raw_smp_processor_id() ||
 	    WARN_ON_ONCE(cpu >= nr_cpu_ids) ||
-	    !cpu_online(cpu)) {
-nodefer:	kfree_skb_napi_cache(skb);
-		return;
-	}
+	    !cpu_online(cpu))
+		return -1;
 
 	DEBUG_NET_WARN_ON_ONCE(skb_dst(skb));
 	DEBUG_NET_WARN_ON_ONCE(skb->destructor);
 	DEBUG_NET_WARN_ON_ONCE(skb_nfct(skb));
 
+	return cpu;
+}
+
+/* Queue the @count skbs chained from @first to @last on @cpu's defer list
+ * for our node, with a single update of its counter and list head.
+ */
+static void skb_defer_ship(int cpu, struct llist_node *first,
+			   struct llist_node *last, unsigned int count)
+{
+	struct skb_defer_node *sdn;
+	unsigned long defer_count;
+	unsigned int defer_max;
+	bool kick;
+
 	sdn = per_cpu_ptr(net_hotdata.skb_defer_nodes, cpu) + numa_node_id();
 
 	defer_max = READ_ONCE(net_hotdata.sysctl_skb_defer_max);
-	defer_count = atomic_long_inc_return(&sdn->defer_count);
+	defer_count = atomic_long_add_return(count, &sdn->defer_count);
 
-	if (defer_count >= defer_max)
-		goto nodefer;
+	if (defer_count >= defer_max) {
+		struct llist_node *next;
+
+		this_cpu_add(softnet_data.defer_drops, count);
+		for (;;) {
+			next = first->next;
+			kfree_skb_napi_cache(llist_entry(first, struct sk_buff,
+							 ll_node));
+			if (first == last)
+				break;
+			first = next;
+		}
+		return;
+	}
 
-	llist_add(&skb->ll_node, &sdn->defer_list);
+	llist_add_batch(first, last, &sdn->defer_list);
 
 	/* Send an IPI every time queue reaches half capacity. */
-	kick = (defer_count - 1) == (defer_max >> 1);
+	kick = defer_count - count <= (defer_max >> 1) &&
+	       defer_count > (defer_max >> 1);
 
 	/* Make sure to trigger NET_RX_SOFTIRQ on the remote CPU
 	 * if we are unlucky enough (this seems very unlikely).
@@ -7319,6 +7335,74 @@ nodefer:	kfree_skb_napi_cache(skb);
 		kick_defer_list_purge(cpu);
 }
 
+/**
+ * skb_attempt_defer_free - queue skb for remote freeing
+ * @skb: buffer
+ *
+ * Put @skb in a per-cpu list, using the cpu which
+ * allocated the skb/pages to reduce false sharing
+ * and memory zone spinlock contention.
+ */
+void skb_attempt_defer_free(struct sk_buff *skb)
+{
+	int cpu = skb_defer_cpu(skb);
+
+	if (cpu < 0) {
+		kfree_skb_napi_cache(skb);
+		return;
+	}
+
+	skb_defer_ship(cpu, &skb->ll_node, &skb->ll_node, 1);
+}
+
+/**
+ * skb_defer_batch_flush - ship the skbs staged in a defer batch
+ * @batch: batch filled by skb_defer_batch_add()
+ */
+void skb_defer_batch_flush(struct skb_defer_batch *batch)
+{
+	if (!batch->count)
+		return;
+
+	skb_defer_ship(batch->cpu, batch->first, batch->last, batch->count);
+	batch->count = 0;
+}
+
+/**
+ * skb_defer_batch_add - stage skb for remote freeing
+ * @batch: caller owned batch, see skb_defer_batch_init()
+ * @skb: buffer
+ *
+ * Like skb_attempt_defer_free(), but consecutive skbs allocated on the
+ * same remote cpu are gathered in @batch and handed over to that cpu
+ * together, instead of touching its defer list once per skb. The caller
+ * must call skb_defer_batch_flush() before @batch goes out of scope.
+ */
+void skb_defer_batch_add(struct skb_defer_batch *batch, struct sk_buff *skb)
+{
+	int cpu = skb_defer_cpu(skb);
+
+	if (cpu < 0) {
+		kfree_skb_napi_cache(skb);
+		return;
+	}
+
+	if (batch->count && batch->cpu != cpu)
+		skb_defer_batch_flush(batch);
+
+	if (!batch->count) {
+		batch->cpu = cpu;
+		batch->last = &skb->ll_node;
+		skb->ll_node.next = NULL;
+	} else {
+		skb->ll_node.next = batch->first;
+	}
+	batch->first = &skb->ll_node;
+
+	if (++batch->count == SKB_DEFER_BATCH)
+		skb_defer_batch_flush(batch);
+}
+
 static void skb_splice_csum_page(struct sk_buff *skb, struct page *page,
 				 size_t offset, size_t len)
 {
@@ -1626,18 +1626,26 @@ void tcp_cleanup_rbuf(struct sock *sk, int copied)
 	__tcp_cleanup_rbuf(sk, copied);
 }
 
-static void tcp_eat_recv_skb(struct sock *sk, struct sk_buff *skb)
+static void __tcp_eat_recv_skb(struct sock *sk, struct sk_buff *skb,
+			       struct skb_defer_batch *batch)
 {
 	__skb_unlink(skb, &sk->sk_receive_queue);
 	if (likely(skb->destructor == sock_rfree)) {
 		sock_rfree(skb);
 		skb->destructor = NULL;
 		skb->sk = NULL;
+		if (batch)
+			return skb_defer_batch_add(batch, skb);
 		return skb_attempt_defer_free(skb);
 	}
 	__kfree_skb(skb);
 }
 
+static void tcp_eat_recv_skb(struct sock *sk, struct sk_buff *skb)
+{
+	__tcp_eat_recv_skb(sk, skb, NULL);
+}
+
 struct sk_buff *tcp_recv_skb(struct sock *sk, u32 seq, u32 *off)
 {
 	struct sk_buff *skb;
@@ -2194,6 +2202,11 @@ static void tcp_zc_finalize_rx_tstamp(struct sock *sk,
 	}
 }
 
+/* Only VMAs created by tcp_mmap() can receive page-flipped payload: pages
+ * are inserted with vm_insert_pages(), which must not replace anonymous
+ * memory such as io_uring provided buffers. The per-VMA lock keeps the
+ * common case off mmap_lock; fall back to it only if the VMA is unstable.
+ */
 static struct vm_area_struct *find_tcp_vma(struct mm_struct *mm,
 					   unsigned long address,
 					   bool *mmap_locked)
@@ -2690,6 +2703,7 @@ static int tcp_recvmsg_locked(struct sock *sk, struct msghdr *msg, size_t len,
 {
 	struct tcp_sock *tp = tcp_sk(sk);
 	int last_copied_dmabuf = -1; /* uninitialized */
+	struct skb_defer_batch defer;
 	int copied = 0;
 	u32 peek_seq;
 	u32 *seq;
@@ -2736,6 +2750,7 @@ static int tcp_recvmsg_locked(struct sock *sk, struct msghdr *msg, size_t len,
 	}
 
 	target = sock_rcvlowat(sk, flags & MSG_WAITALL, len);
+	skb_defer_batch_init(&defer);
 
 	do {
 		u32 offset;
@@ -2825,6 +2840,7 @@ static int tcp_recvmsg_locked(struct sock *sk, struct msghdr *msg, size_t len,
 			/* Do not sleep, just process backlog. */
 			__sk_flush_backlog(sk);
 		} else {
+			skb_defer_batch_flush(&defer);
 			tcp_cleanup_rbuf(sk, copied);
 			err = sk_wait_data(sk, &timeo, last);
 			if (err < 0) {
@@ -2931,17 +2947,19 @@ static int tcp_recvmsg_locked(struct sock *sk, struct msghdr *msg, size_t len,
 		if (TCP_SKB_CB(skb)->tcp_flags & TCPHDR_FIN)
 			goto found_fin_ok;
 		if (!(flags & MSG_PEEK))
-			tcp_eat_recv_skb(sk, skb);
+			__tcp_eat_recv_skb(sk, skb, &defer);
 		continue;
 
 found_fin_ok:
 		/* Process the FIN. */
 		WRITE_ONCE(*seq, *seq + 1);
 		if (!(flags & MSG_PEEK))
-			tcp_eat_recv_skb(sk, skb);
+			__tcp_eat_recv_skb(sk, skb, &defer);
 		break;
 	} while (len > 0);
 
+	skb_defer_batch_flush(&defer);
+
 	/* According to UNIX98, msg_name/msg_namelen are ignored
 	 * on connected socket. I was just happy when found this 8) --ANK
 	 */
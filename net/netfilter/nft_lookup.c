@@ -46,6 +46,10 @@ __nft_set_do_lookup(const struct net *net, const struct nft_set *set,
 	if (set->ops == &nft_set_pipapo_avx2_type.ops)
 		return nft_pipapo_avx2_lookup(net, set, key);
 #endif
+#ifdef CONFIG_ARM64
+	if (set->ops == &nft_set_pipapo_neon_type.ops)
+		return nft_pipapo_neon_lookup(net, set, key);
+#endif
 
 	if (set->ops == &nft_set_rbtree_type.ops)
 		return nft_rbtree_lookup(net, set, key);
@@ -340,8 +340,13 @@
 #include <linux/bitops.h>
 
 #include "nft_set_pipapo_avx2.h"
+#include "nft_set_pipapo_neon.h"
 #include "nft_set_pipapo.h"
 
+#ifdef CONFIG_ARM64
+#include <asm/simd.h>
+#endif
+
 /**
  * pipapo_refill() - For each set bit, set bits from selected mapping table item
  * @map:	Bitmap to be scanned for set bits
@@ -515,7 +520,7 @@ static struct nft_pipapo_elem *pipapo_get_slow(const struct nft_pipapo_match *m,
  * @tstamp:	Timestamp to check for expired elements
  *
  * This is a dispatcher function, either calling out the generic C
- * implementation or, if available, the AVX2 one.
+ * implementation or, if available, the AVX2 or NEON one.
  * This helper is only called from the control plane, with either RCU
  * read lock or transaction mutex held.
  *
@@ -535,6 +540,13 @@ static struct nft_pipapo_elem *pipapo_get(const struct nft_pipapo_match *m,
 		local_bh_enable();
 		return e;
 	}
+#endif
+#ifdef CONFIG_ARM64
+	if (cpu_has_neon() && may_use_simd()) {
+		e = pipapo_get_neon(m, data, genmask, tstamp);
+		local_bh_enable();
+		return e;
+	}
 #endif
 	e = pipapo_get_slow(m, data, genmask, tstamp);
 	local_bh_enable();
@@ -2442,3 +2454,29 @@ const struct nft_set_type nft_set_pipapo_avx2_type = {
 	},
 };
 #endif
+
+#ifdef CONFIG_ARM64
+const struct nft_set_type nft_set_pipapo_neon_type = {
+	.features	= NFT_SET_INTERVAL | NFT_SET_MAP | NFT_SET_OBJECT |
+			  NFT_SET_TIMEOUT,
+	.ops		= {
+		.lookup		= nft_pipapo_neon_lookup,
+		.insert		= nft_pipapo_insert,
+		.activate	= nft_pipapo_activate,
+		.deactivate	= nft_pipapo_deactivate,
+		.flush		= nft_pipapo_flush,
+		.remove		= nft_pipapo_remove,
+		.walk		= nft_pipapo_walk,
+		.get		= nft_pipapo_get,
+		.privsize	= nft_pipapo_privsize,
+		.estimate	= nft_pipapo_neon_estimate,
+		.init		= nft_pipapo_init,
+		.destroy	= nft_pipapo_destroy,
+		.gc_init	= nft_pipapo_gc_init,
+		.commit		= nft_pipapo_commit,
+		.abort		= nft_pipapo_abort,
+		.abort_skip_removal = true,
+		.elemsize	= offsetof(struct nft_pipapo_elem, ext),
+	},
+};
+#endif
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* PIPAPO: PIle PAcket POlicies: NEON packet lookup routines
+ *
+ * Same algorithm as the generic implementation, see DOC: Theory of Operation
+ * in nft_set_pipapo.c, with bucket intersection done in NEON registers by
+ * nft_set_pipapo_neon_inner.c.
+ */
+
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/module.h>
+#include <linux/netlink.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter/nf_tables.h>
+#include <net/netfilter/nf_tables_core.h>
+#include <uapi/linux/netfilter/nf_tables.h>
+#include <linux/bitmap.h>
+#include <linux/bitops.h>
+
+#include <asm/neon.h>
+#include <asm/simd.h>
+
+#include "nft_set_pipapo_neon.h"
+#include "nft_set_pipapo.h"
+
+/* Largest number of groups in a field: 4-bit groups in a 128-bit field */
+#define NFT_PIPAPO_NEON_MAX_GROUPS						\
+	(NFT_PIPAPO_MAX_BITS / NFT_PIPAPO_GROUP_BITS_LARGE_SET)
+
+/* in nft_set_pipapo_neon_inner.c */
+int nft_pipapo_neon_and(unsigned long *dst, const unsigned long *const *rows,
+			int nrows, unsigned int bsize);
+
+/**
+ * nft_pipapo_neon_and_field() - Intersect buckets selected by packet data
+ * @f:		Field including lookup table
+ * @dst:	Area to store result
+ * @data:	Input data selecting table buckets
+ *
+ * Return: true if any bit is left set in @dst.
+ */
+static bool nft_pipapo_neon_and_field(const struct nft_pipapo_field *f,
+				      unsigned long *dst, const u8 *data)
+{
+	const unsigned long *rows[NFT_PIPAPO_NEON_MAX_GROUPS];
+	unsigned long *lt = NFT_PIPAPO_LT_ALIGN(f->lt);
+	int group;
+
+	for (group = 0; group < f->groups; group++) {
+		u8 v;
+
+		if (likely(f->bb == 8))
+			v = data[group];
+		else if (group % 2)
+			v = data[group / 2] & 0x0f;
+		else
+			v = data[group / 2] >> 4;
+		NFT_PIPAPO_GROUP_BITS_ARE_8_OR_4;
+
+		rows[group] = lt + v * f->bsize;
+		lt += f->bsize * NFT_PIPAPO_BUCKETS(f->bb);
+	}
+
+	return nft_pipapo_neon_and(dst, rows, f->groups, f->bsize);
+}
+
+/**
+ * nft_pipapo_neon_estimate() - Set size, space and lookup complexity
+ * @desc:	Set description, element count and field description used
+ * @features:	Flags: NFT_SET_INTERVAL needs to be there
+ * @est:	Storage for estimation data
+ *
+ * Return: true if set is compatible and NEON available, false otherwise.
+ */
+bool nft_pipapo_neon_estimate(const struct nft_set_desc *desc, u32 features,
+			      struct nft_set_estimate *est)
+{
+	if (!(features & NFT_SET_INTERVAL) ||
+	    desc->field_count < NFT_PIPAPO_MIN_FIELDS)
+		return false;
+
+	if (!cpu_has_neon())
+		return false;
+
+	est->size = pipapo_estimate_size(desc);
+	if (!est->size)
+		return false;
+
+	est->lookup = NFT_SET_CLASS_O_LOG_N;
+
+	est->space = NFT_SET_CLASS_O_N;
+
+	return true;
+}
+
+static struct nft_pipapo_elem *__pipapo_get_neon(const struct nft_pipapo_match *m,
+						 const u8 *data, u8 genmask,
+						 u64 tstamp)
+{
+	unsigned long *res_map, *fill_map, *map;
+	struct nft_pipapo_scratch *scratch;
+	const struct nft_pipapo_field *f;
+	bool map_index;
+	int i;
+
+	scratch = *raw_cpu_ptr(m->scratch);
+	if (unlikely(!scratch))
+		return NULL;
+
+	__local_lock_nested_bh(&scratch->bh_lock);
+	map_index = scratch->map_index;
+	map = NFT_PIPAPO_LT_ALIGN(&scratch->__map[0]);
+	res_map  = map + (map_index ? m->bsize_max : 0);
+	fill_map = map + (map_index ? 0 : m->bsize_max);
+
+	pipapo_resmap_init(m, res_map);
+
+	nft_pipapo_for_each_field(f, i, m) {
+		bool last = i == m->field_count - 1;
+		int b;
+
+		/* No bits left: res_map is clean, as if pipapo_refill() had
+		 * consumed it, and can be reused for the next packet.
+		 */
+		if (!nft_pipapo_neon_and_field(f, res_map, data))
+			break;
+
+next_match:
+		b = pipapo_refill(res_map, f->bsize, f->rules, fill_map, f->mt,
+				  last);
+		if (b < 0)
+			break;
+
+		if (last) {
+			struct nft_pipapo_elem *e;
+
+			e = f->mt[b].e;
+			if (unlikely(__nft_set_elem_expired(&e->ext, tstamp) ||
+				     !nft_set_elem_active(&e->ext, genmask)))
+				goto next_match;
+
+			scratch->map_index = map_index;
+			__local_unlock_nested_bh(&scratch->bh_lock);
+			return e;
+		}
+
+		map_index = !map_index;
+		swap(res_map, fill_map);
+		data += NFT_PIPAPO_GROUPS_PADDED_SIZE(f);
+	}
+
+	scratch->map_index = map_index;
+	__local_unlock_nested_bh(&scratch->bh_lock);
+	return NULL;
+}
+
+/**
+ * pipapo_get_neon() - Lookup function for NEON implementation
+ * @m:		Storage containing the set elements
+ * @data:	Key data to be matched against existing elements
+ * @genmask:	If set, check that element is active in given genmask
+ * @tstamp:	Timestamp to check for expired elements
+ *
+ * The caller must check that SIMD is usable.
+ * This function must be called with BH disabled.
+ *
+ * Return: pointer to &struct nft_pipapo_elem on match, NULL otherwise.
+ */
+struct nft_pipapo_elem *pipapo_get_neon(const struct nft_pipapo_match *m,
+					const u8 *data, u8 genmask,
+					u64 tstamp)
+{
+	struct nft_pipapo_elem *e;
+
+	scoped_ksimd()
+		e = __pipapo_get_neon(m, data, genmask, tstamp);
+
+	return e;
+}
+
+/**
+ * nft_pipapo_neon_lookup() - Dataplane frontend for NEON implementation
+ * @net:	Network namespace
+ * @set:	nftables API set representation
+ * @key:	nftables API element representation containing key data
+ *
+ * This function is called from the data path.  It will search for
+ * an element matching the given key in the current active copy using
+ * the NEON routines if SIMD is usable or fall back to the generic
+ * implementation of the algorithm otherwise.
+ *
+ * Return: nftables API extension pointer or NULL if no match.
+ */
+const struct nft_set_ext *
+nft_pipapo_neon_lookup(const struct net *net, const struct nft_set *set,
+		       const u32 *key)
+{
+	struct nft_pipapo *priv = nft_set_priv(set);
+	const struct nft_pipapo_match *m;
+	const u8 *rp = (const u8 *)key;
+	const struct nft_pipapo_elem *e;
+
+	local_bh_disable();
+
+	if (unlikely(!may_use_simd())) {
+		const struct nft_set_ext *ext;
+
+		ext = nft_pipapo_lookup(net, set, key);
+
+		local_bh_enable();
+		return ext;
+	}
+
+	m = rcu_dereference(priv->match);
+
+	e = pipapo_get_neon(m, rp, 0, get_jiffies_64());
+	local_bh_enable();
+
+	return e ? &e->ext : NULL;
+}
@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _NFT_SET_PIPAPO_NEON_H
+#define _NFT_SET_PIPAPO_NEON_H
+
+#ifdef CONFIG_ARM64
+struct nft_pipapo_match;
+bool nft_pipapo_neon_estimate(const struct nft_set_desc *desc, u32 features,
+			      struct nft_set_estimate *est);
+struct nft_pipapo_elem *pipapo_get_neon(const struct nft_pipapo_match *m,
+					const u8 *data, u8 genmask,
+					u64 tstamp);
+#endif /* CONFIG_ARM64 */
+
+#endif /* _NFT_SET_PIPAPO_NEON_H */
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* PIPAPO: PIle PAcket POlicies: NEON bucket intersection
+ *
+ * This file is built with FP/SIMD enabled, and must only be called between
+ * kernel_neon_begin() and kernel_neon_end(). It can't include regular kernel
+ * headers, see nft_set_pipapo_neon.c for the rest of the implementation.
+ */
+
+#include <asm/neon-intrinsics.h>
+
+int nft_pipapo_neon_and(unsigned long *dst, const unsigned long *const *rows,
+			int nrows, unsigned int bsize);
+
+/**
+ * nft_pipapo_neon_and() - AND selected buckets of all groups into a bitmap
+ * @dst:	Bitmap to intersect, bsize longs
+ * @rows:	One selected bucket per group
+ * @nrows:	Number of groups
+ * @bsize:	Bucket size, in longs
+ *
+ * Unlike the generic implementation, which intersects one whole bucket at a
+ * time, take 128 bits of @dst and AND them with the matching 128 bits from
+ * all the buckets before storing them back, so that @dst is only written
+ * once per field.
+ *
+ * Return: non-zero if any bit is left set in @dst.
+ */
+int nft_pipapo_neon_and(unsigned long *dst, const unsigned long *const *rows,
+			int nrows, unsigned int bsize)
+{
+	uint64x2_t any = vdupq_n_u64(0);
+	unsigned long tail = 0;
+	unsigned int i;
+	int g;
+
+	for (i = 0; i + 2 <= bsize; i += 2) {
+		uint64x2_t acc = vld1q_u64((const uint64_t *)&dst[i]);
+
+		for (g = 0; g < nrows; g++)
+			acc = vandq_u64(acc,
+					vld1q_u64((const uint64_t *)&rows[g][i]));
+
+		vst1q_u64((uint64_t *)&dst[i], acc);
+		any = vorrq_u64(any, acc);
+	}
+
+	if (i < bsize) {
+		tail = dst[i];
+		for (g = 0; g < nrows; g++)
+			tail &= rows[g][i];
+		dst[i] = tail;
+	}
+
+	return vmaxvq_u32(vreinterpretq_u32_u64(any)) || tail;
+}
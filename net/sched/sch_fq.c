@@ -135,6 +135,7 @@ struct fq_sched_data {
 	struct fq_perband_flows band_flows[FQ_BANDS];
 
 	struct fq_flow	internal;	/* fastpath queue. */
+	struct fq_flow	*last_flow;	/* last flow found by fq_classify() */
 	struct rb_root	delayed;	/* for rate limited flows */
 	u64		time_next_delayed_flow;
 	unsigned long	unthrottle_latency_ns;
@@ -288,6 +289,8 @@ static void fq_gc(struct fq_sched_data *q,
 	while (tofree) {
 		f = tofree;
 		tofree = f->next;
+		if (f == q->last_flow)
+			q->last_flow = NULL;
 		rb_erase(&f->fq_node, root);
 		kmem_cache_free(fq_flow_cachep, f);
 		fcnt++;
@@ -398,6 +401,15 @@ static struct fq_flow *fq_classify(struct Qdisc *sch, struct sk_buff *skb,
 		return &q->internal;
 	}
 
+	/* Back-to-back packets mostly come from the same flow (TSO trains,
+	 * batches drained from the qdisc defer list): skip the rbtree walk.
+	 * A reallocated socket takes the slow path to refill its credit.
+	 */
+	f = q->last_flow;
+	if (f && f->sk == sk &&
+	    likely(skb->sk != sk || f->socket_hash == sk->sk_hash))
+		return f;
+
 	root = &q->fq_root[hash_ptr(sk, q->fq_trees_log)];
 
 	fq_gc(q, root, sk);
@@ -425,6 +437,7 @@ static struct fq_flow *fq_classify(struct Qdisc *sch, struct sk_buff *skb,
 					fq_flow_unset_throttled(q, f);
 				f->time_next_packet = 0ULL;
 			}
+			q->last_flow = f;
 			return f;
 		}
 		if (f->sk > sk)
@@ -452,6 +465,7 @@ static struct fq_flow *fq_classify(struct Qdisc *sch, struct sk_buff *skb,
 
 	rb_link_node(&f->fq_node, parent, p);
 	rb_insert_color(&f->fq_node, root);
+	q->last_flow = f;
 
 	q->flows++;
 	q->inactive_flows++;
@@ -809,6 +823,7 @@ static void fq_reset(struct Qdisc *sch)
 	sch->qstats.backlog = 0;
 
 	fq_flow_purge(&q->internal);
+	q->last_flow = NULL;
 
 	if (!q->fq_root)
 		return;
@@ -845,6 +860,7 @@ static void fq_rehash(struct fq_sched_data *q,
 	int fcnt = 0;
 	u32 idx;
 
+	q->last_flow = NULL;
 	for (idx = 0; idx < (1U << old_log); idx++) {
 		oroot = &old_array[idx];
 		while ((op = rb_first(oroot)) != NULL) {
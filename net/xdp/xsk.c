@@ -905,9 +905,61 @@ static struct sk_buff *xsk_build_skb(struct xdp_sock *xs,
 	return ERR_PTR(err);
 }
 
+/* Number of complete packets handed to the driver at once */
+#define XSK_GENERIC_XMIT_BATCH	16
+
+struct xsk_tx_batch {
+	struct sk_buff *head;
+	struct sk_buff **tail;
+	u32 nr;
+};
+
+static void xsk_tx_batch_add(struct xsk_tx_batch *batch, struct sk_buff *skb)
+{
+	*batch->tail = skb;
+	batch->tail = &skb->next;
+	batch->nr++;
+}
+
+/* The batch only ever holds the most recently released descriptors, so
+ * whatever the driver refuses can be handed back to the tx ring.
+ */
+static int xsk_tx_batch_flush(struct xdp_sock *xs, struct xsk_tx_batch *batch)
+{
+	struct sk_buff *skb, *next;
+	u32 num_descs = 0;
+	int ret;
+
+	*batch->tail = NULL;
+	skb = __dev_direct_xmit_list(batch->head, xs->queue_id, &ret);
+	batch->head = NULL;
+	batch->tail = &batch->head;
+	batch->nr = 0;
+
+	if (skb) {
+		/* Tell user-space to retry the send */
+		for (; skb; skb = next) {
+			next = skb->next;
+			skb_mark_not_on_list(skb);
+			num_descs += xsk_get_num_desc(skb);
+			xsk_consume_skb(skb);
+		}
+		xskq_cons_cancel_n(xs->tx, num_descs);
+		return -EAGAIN;
+	}
+
+	/* Ignore NET_XMIT_CN as packet might have been sent */
+	if (ret == NET_XMIT_DROP) {
+		/* SKB completed but not sent */
+		return -EBUSY;
+	}
+	return 0;
+}
+
 static int __xsk_generic_xmit(struct sock *sk)
 {
 	struct xdp_sock *xs = xdp_sk(sk);
+	struct xsk_tx_batch batch = { .tail = &batch.head };
 	bool sent_frame = false;
 	struct xdp_desc desc;
 	struct sk_buff *skb;
@@ -932,6 +984,16 @@ static int __xsk_generic_xmit(struct sock *sk)
 			goto out;
 		}
 
+		/* Flush single buffer packets before starting a multi-buffer
+		 * one, its error handling consumes descriptors on its own.
+		 */
+		if (batch.nr && xp_mb_desc(&desc)) {
+			sent_frame = true;
+			err = xsk_tx_batch_flush(xs, &batch);
+			if (err)
+				goto out;
+		}
+
 		/* This is the backpressure mechanism for the Tx path.
 		 * Reserve space in the completion queue and only proceed
 		 * if there is space in it. This avoids having to implement
@@ -959,25 +1021,21 @@ static int __xsk_generic_xmit(struct sock *sk)
 			continue;
 		}
 
-		err = __dev_direct_xmit(skb, xs->queue_id);
-		if  (err == NETDEV_TX_BUSY) {
-			/* Tell user-space to retry the send */
-			xskq_cons_cancel_n(xs->tx, xsk_get_num_desc(skb));
-			xsk_consume_skb(skb);
-			err = -EAGAIN;
-			goto out;
-		}
-
-		/* Ignore NET_XMIT_CN as packet might have been sent */
-		if (err == NET_XMIT_DROP) {
-			/* SKB completed but not sent */
-			err = -EBUSY;
-			xs->skb = NULL;
-			goto out;
+		xs->skb = NULL;
+		xsk_tx_batch_add(&batch, skb);
+		if (batch.nr == XSK_GENERIC_XMIT_BATCH) {
+			sent_frame = true;
+			err = xsk_tx_batch_flush(xs, &batch);
+			if (err)
+				goto out;
 		}
+	}
 
+	if (batch.nr) {
 		sent_frame = true;
-		xs->skb = NULL;
+		err = xsk_tx_batch_flush(xs, &batch);
+		if (err)
+			goto out;
 	}
 
 	if (xskq_has_descs(xs->tx)) {
@@ -987,6 +1045,14 @@ static int __xsk_generic_xmit(struct sock *sk)
 	}
 
 out:
+	if (batch.nr) {
+		int ret;
+
+		sent_frame = true;
+		ret = xsk_tx_batch_flush(xs, &batch);
+		if (!err)
+			err = ret;
+	}
 	if (sent_frame)
 		__xsk_tx_release(xs);
 
@@ -20,6 +20,11 @@ static char *directions[] = {
 	"FROM_DEVICE",
 };
 
+static char *modes[] = {
+	"SINGLE",
+	"SG",
+};
+
 int main(int argc, char **argv)
 {
 	struct map_benchmark map;
@@ -30,10 +35,12 @@ int main(int argc, char **argv)
 	int bits = 32, xdelay = 0, dir = DMA_MAP_BIDIRECTIONAL;
 	/* default granule 1 PAGESIZE */
 	int granule = 1;
+	/* default dma_map_single() */
+	int mode = DMA_MAP_SINGLE_MODE;
 
 	int cmd = DMA_MAP_BENCHMARK;
 
-	while ((opt = getopt(argc, argv, "t:s:n:b:d:x:g:")) != -1) {
+	while ((opt = getopt(argc, argv, "t:s:n:b:d:x:g:m:")) != -1) {
 		switch (opt) {
 		case 't':
 			threads = atoi(optarg);
@@ -56,6 +63,9 @@ int main(int argc, char **argv)
 		case 'g':
 			granule = atoi(optarg);
 			break;
+		case 'm':
+			mode = atoi(optarg);
+			break;
 		default:
 			return -1;
 		}
@@ -96,6 +106,11 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (mode != DMA_MAP_SINGLE_MODE && mode != DMA_MAP_SG_MODE) {
+		fprintf(stderr, "invalid map mode\n");
+		exit(1);
+	}
+
 	fd = open("/sys/kernel/debug/dma_map_benchmark", O_RDWR);
 	if (fd == -1) {
 		perror("open");
@@ -110,14 +125,15 @@ int main(int argc, char **argv)
 	map.dma_dir = dir;
 	map.dma_trans_ns = xdelay;
 	map.granule = granule;
+	map.map_mode = mode;
 
 	if (ioctl(fd, cmd, &map)) {
 		perror("ioctl");
 		exit(1);
 	}
 
-	printf("dma mapping benchmark: threads:%d seconds:%d node:%d dir:%s granule: %d\n",
-			threads, seconds, node, directions[dir], granule);
+	printf("dma mapping benchmark: threads:%d seconds:%d node:%d dir:%s granule: %d mode:%s\n",
+			threads, seconds, node, directions[dir], granule, modes[mode]);
 	printf("average map latency(us):%.1f standard deviation:%.1f\n",
 			map.avg_map_100ns/10.0, map.map_stddev/10.0);
 	printf("average unmap latency(us):%.1f standard deviation:%.1f\n",
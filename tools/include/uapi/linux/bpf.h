@@ -6696,6 +6696,8 @@ struct bpf_prog_info {
 	__u32 verified_insns;
 	__u32 attach_btf_obj_id;
 	__u32 attach_btf_id;
+	__u32 :32; /* alignment pad */
+	__u64 verification_time_ns;
 } __attribute__((aligned(8)));
 
 struct bpf_map_info {
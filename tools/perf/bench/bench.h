@@ -50,6 +50,10 @@ int bench_uprobe_trace_printk(int argc, const char **argv);
 int bench_uprobe_empty_ret(int argc, const char **argv);
 int bench_uprobe_trace_printk_ret(int argc, const char **argv);
 int bench_pmu_scan(int argc, const char **argv);
+int bench_fs_seq_read(int argc, const char **argv);
+int bench_fs_random_read(int argc, const char **argv);
+int bench_fs_mmap_read(int argc, const char **argv);
+int bench_uring_nop(int argc, const char **argv);
 
 #define BENCH_FORMAT_DEFAULT_STR	"default"
 #define BENCH_FORMAT_DEFAULT		0
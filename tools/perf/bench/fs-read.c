@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * fs-read.c
+ *
+ * Buffered read() and mmap() benchmarks for the page cache and readahead
+ * paths. A scratch file is created in the given directory, so pointing
+ * --dir at a tmpfs or at a block-backed filesystem compares the two.
+ */
+
+#include "../perf.h"
+#include "../util/util.h"
+#include "../util/string2.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <linux/time64.h>
+
+static const char	*dir_str	= ".";
+static const char	*size_str	= "256MB";
+static const char	*block_size_str	= "128KB";
+static const char	*advice_str	= "normal";
+static unsigned int	nr_loops	= 1;
+static bool		cold;
+
+static const struct option options[] = {
+	OPT_STRING('d', "dir", &dir_str, "DIR",
+		   "Directory to create the scratch file in"),
+	OPT_STRING('s', "size", &size_str, "256MB",
+		   "Size of the scratch file. "
+		   "Available units: B, KB, MB, GB and TB (case insensitive)"),
+	OPT_STRING('b', "block-size", &block_size_str, "128KB",
+		   "Size of each read() call"),
+	OPT_STRING('a', "advice", &advice_str, "normal",
+		   "posix_fadvise() hint: normal, sequential, random or willneed"),
+	OPT_UINTEGER('l', "nr_loops", &nr_loops,
+		     "Number of passes over the file (default: 1)"),
+	OPT_BOOLEAN('c', "cold", &cold,
+		    "Drop the file from the page cache before each pass"),
+	OPT_END()
+};
+
+static const char * const bench_fs_usage[] = {
+	"perf bench fs <options>",
+	NULL
+};
+
+enum fs_read_mode {
+	FS_READ_SEQ,
+	FS_READ_RANDOM,
+	FS_READ_MMAP,
+};
+
+static int parse_advice(const char *str)
+{
+	if (!strcmp(str, "normal"))
+		return POSIX_FADV_NORMAL;
+	if (!strcmp(str, "sequential"))
+		return POSIX_FADV_SEQUENTIAL;
+	if (!strcmp(str, "random"))
+		return POSIX_FADV_RANDOM;
+	if (!strcmp(str, "willneed"))
+		return POSIX_FADV_WILLNEED;
+	return -1;
+}
+
+static int create_file(const char *dir, size_t size, size_t bs)
+{
+	char path[PATH_MAX];
+	size_t done;
+	char *buf;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/perf-bench-fs.XXXXXX", dir);
+	fd = mkstemp(path);
+	if (fd < 0) {
+		fprintf(stderr, "Failed to create scratch file in %s: %s\n",
+			dir, strerror(errno));
+		return -1;
+	}
+	unlink(path);
+
+	buf = malloc(bs);
+	if (!buf)
+		goto out_close;
+	memset(buf, 0x5a, bs);
+
+	for (done = 0; done < size; done += bs) {
+		if (write(fd, buf, bs) != (ssize_t)bs) {
+			fprintf(stderr, "Failed to fill scratch file: %s\n",
+				strerror(errno));
+			free(buf);
+			goto out_close;
+		}
+	}
+	free(buf);
+
+	fsync(fd);
+	return fd;
+
+out_close:
+	close(fd);
+	return -1;
+}
+
+static int read_pass(int fd, enum fs_read_mode mode, size_t size, size_t bs,
+		     char *buf)
+{
+	size_t nr_blocks = size / bs;
+	long psize = sysconf(_SC_PAGESIZE);
+	volatile char sink;
+	size_t i, off;
+	char *map;
+
+	if (mode == FS_READ_MMAP) {
+		map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (map == MAP_FAILED)
+			return -1;
+		for (off = 0; off < size; off += psize)
+			sink = map[off];
+		(void)sink;
+		munmap(map, size);
+		return 0;
+	}
+
+	for (i = 0; i < nr_blocks; i++) {
+		off = mode == FS_READ_RANDOM ? (size_t)(random() % nr_blocks) : i;
+		if (pread(fd, buf, bs, off * bs) != (ssize_t)bs)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int bench_fs_common(int argc, const char **argv, enum fs_read_mode mode)
+{
+	struct timeval start, stop, diff;
+	double result_bps;
+	size_t size, bs;
+	int fd, advice;
+	unsigned int i;
+	char *buf;
+
+	argc = parse_options(argc, argv, options, bench_fs_usage, 0);
+	if (argc) {
+		usage_with_options(bench_fs_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	size = (size_t)perf_atoll((char *)size_str);
+	bs = (size_t)perf_atoll((char *)block_size_str);
+	if ((s64)size <= 0 || (s64)bs <= 0 || bs > size) {
+		fprintf(stderr, "Invalid size:%s or block size:%s\n",
+			size_str, block_size_str);
+		return 1;
+	}
+	size -= size % bs;
+
+	advice = parse_advice(advice_str);
+	if (advice < 0) {
+		fprintf(stderr, "Invalid advice:%s\n", advice_str);
+		return 1;
+	}
+
+	buf = malloc(bs);
+	if (!buf)
+		return 1;
+
+	fd = create_file(dir_str, size, bs);
+	if (fd < 0) {
+		free(buf);
+		return 1;
+	}
+
+	timerclear(&diff);
+	for (i = 0; i < nr_loops; i++) {
+		if (cold)
+			posix_fadvise(fd, 0, size, POSIX_FADV_DONTNEED);
+		posix_fadvise(fd, 0, size, advice);
+
+		gettimeofday(&start, NULL);
+		if (read_pass(fd, mode, size, bs, buf) < 0) {
+			fprintf(stderr, "Read failed: %s\n", strerror(errno));
+			close(fd);
+			free(buf);
+			return 1;
+		}
+		gettimeofday(&stop, NULL);
+
+		timersub(&stop, &start, &stop);
+		timeradd(&diff, &stop, &diff);
+	}
+
+	close(fd);
+	free(buf);
+
+	result_bps = (double)size * nr_loops /
+		     ((double)diff.tv_sec + (double)diff.tv_usec / USEC_PER_SEC);
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# Reading %s file in %s, %u pass(es)%s\n\n",
+		       size_str, dir_str, nr_loops, cold ? ", cold cache" : "");
+		printf(" %14s: %lu.%03lu [sec]\n", "Total time",
+		       (unsigned long)diff.tv_sec,
+		       (unsigned long)(diff.tv_usec / USEC_PER_MSEC));
+		printf(" %14lf MB/sec\n", result_bps / (1 << 20));
+		break;
+
+	case BENCH_FORMAT_SIMPLE:
+		printf("%lf\n", result_bps);
+		break;
+
+	default:
+		/* reaching here is something disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		exit(1);
+	}
+
+	return 0;
+}
+
+int bench_fs_seq_read(int argc, const char **argv)
+{
+	return bench_fs_common(argc, argv, FS_READ_SEQ);
+}
+
+int bench_fs_random_read(int argc, const char **argv)
+{
+	return bench_fs_common(argc, argv, FS_READ_RANDOM);
+}
+
+int bench_fs_mmap_read(int argc, const char **argv)
+{
+	return bench_fs_common(argc, argv, FS_READ_MMAP);
+}
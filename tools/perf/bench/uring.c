@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * uring.c
+ *
+ * io_uring submission/completion path benchmark. The rings are set up
+ * with the raw syscalls so that no liburing is needed, and batches of
+ * IORING_OP_NOP requests are pushed through io_uring_enter().
+ */
+
+#include "../perf.h"
+#include "../util/util.h"
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <linux/io_uring.h>
+#include <linux/time64.h>
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup	425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter	426
+#endif
+
+static unsigned int	nr_entries	= 128;
+static unsigned int	nr_batch	= 32;
+static unsigned int	nr_ops		= 10000000;
+static bool		defer_taskrun;
+
+static const struct option options[] = {
+	OPT_UINTEGER('e', "entries", &nr_entries,
+		     "Number of SQ ring entries (default: 128)"),
+	OPT_UINTEGER('b', "batch", &nr_batch,
+		     "Number of requests per io_uring_enter() (default: 32)"),
+	OPT_UINTEGER('l', "nr_ops", &nr_ops,
+		     "Number of requests to complete (default: 10000000)"),
+	OPT_BOOLEAN('d', "defer-taskrun", &defer_taskrun,
+		    "Set up the ring with IORING_SETUP_DEFER_TASKRUN"),
+	OPT_END()
+};
+
+static const char * const bench_uring_usage[] = {
+	"perf bench uring <options>",
+	NULL
+};
+
+struct bench_ring {
+	int			fd;
+	unsigned int		*sq_tail;
+	unsigned int		*sq_mask;
+	unsigned int		*sq_array;
+	unsigned int		*cq_head;
+	unsigned int		*cq_tail;
+	unsigned int		*cq_mask;
+	struct io_uring_sqe	*sqes;
+	struct io_uring_cqe	*cqes;
+	void			*sq_ptr;
+	void			*cq_ptr;
+	size_t			sq_len;
+	size_t			cq_len;
+	size_t			sqes_len;
+};
+
+static int ring_setup(struct bench_ring *ring, unsigned int entries,
+		      unsigned int flags)
+{
+	struct io_uring_params p;
+
+	memset(&p, 0, sizeof(p));
+	p.flags = flags;
+
+	ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0)
+		return -1;
+
+	ring->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+	ring->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_len > ring->sq_len)
+			ring->sq_len = ring->cq_len;
+		ring->cq_len = ring->sq_len;
+	}
+
+	ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ptr == MAP_FAILED)
+		goto out_close;
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ptr = ring->sq_ptr;
+	} else {
+		ring->cq_ptr = mmap(NULL, ring->cq_len, PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_POPULATE, ring->fd,
+				    IORING_OFF_CQ_RING);
+		if (ring->cq_ptr == MAP_FAILED)
+			goto out_unmap_sq;
+	}
+
+	ring->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+		goto out_unmap_cq;
+
+	ring->sq_tail = ring->sq_ptr + p.sq_off.tail;
+	ring->sq_mask = ring->sq_ptr + p.sq_off.ring_mask;
+	ring->sq_array = ring->sq_ptr + p.sq_off.array;
+	ring->cq_head = ring->cq_ptr + p.cq_off.head;
+	ring->cq_tail = ring->cq_ptr + p.cq_off.tail;
+	ring->cq_mask = ring->cq_ptr + p.cq_off.ring_mask;
+	ring->cqes = ring->cq_ptr + p.cq_off.cqes;
+
+	return 0;
+
+out_unmap_cq:
+	if (ring->cq_ptr != ring->sq_ptr)
+		munmap(ring->cq_ptr, ring->cq_len);
+out_unmap_sq:
+	munmap(ring->sq_ptr, ring->sq_len);
+out_close:
+	close(ring->fd);
+	return -1;
+}
+
+static void ring_exit(struct bench_ring *ring)
+{
+	munmap(ring->sqes, ring->sqes_len);
+	if (ring->cq_ptr != ring->sq_ptr)
+		munmap(ring->cq_ptr, ring->cq_len);
+	munmap(ring->sq_ptr, ring->sq_len);
+	close(ring->fd);
+}
+
+/* Queue @nr NOP requests and wait for all of them to complete */
+static int ring_submit_nops(struct bench_ring *ring, unsigned int nr)
+{
+	unsigned int tail = *ring->sq_tail;
+	unsigned int mask = *ring->sq_mask;
+	unsigned int head, done = 0;
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		unsigned int idx = tail & mask;
+		struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = IORING_OP_NOP;
+		ring->sq_array[idx] = idx;
+		tail++;
+	}
+	__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+	if (syscall(__NR_io_uring_enter, ring->fd, nr, nr,
+		    IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+		return -1;
+
+	head = *ring->cq_head;
+	mask = *ring->cq_mask;
+	while (done < nr) {
+		tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++, done++) {
+			if (ring->cqes[head & mask].res < 0) {
+				errno = -ring->cqes[head & mask].res;
+				return -1;
+			}
+		}
+		__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+	}
+
+	return 0;
+}
+
+int bench_uring_nop(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	unsigned long long result_usec;
+	struct bench_ring ring;
+	unsigned int flags = 0;
+	unsigned int done;
+
+	argc = parse_options(argc, argv, options, bench_uring_usage, 0);
+	if (argc) {
+		usage_with_options(bench_uring_usage, options);
+		exit(EXIT_FAILURE);
+	}
+
+	if (!nr_batch || nr_batch > nr_entries) {
+		fprintf(stderr, "Invalid batch:%u, must be in [1, %u]\n",
+			nr_batch, nr_entries);
+		return 1;
+	}
+
+	if (defer_taskrun)
+		flags |= IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+
+	if (ring_setup(&ring, nr_entries, flags) < 0) {
+		fprintf(stderr, "io_uring_setup failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	gettimeofday(&start, NULL);
+	for (done = 0; done < nr_ops; done += nr_batch) {
+		if (ring_submit_nops(&ring, nr_batch) < 0) {
+			fprintf(stderr, "io_uring_enter failed: %s\n",
+				strerror(errno));
+			ring_exit(&ring);
+			return 1;
+		}
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	ring_exit(&ring);
+
+	result_usec = diff.tv_sec * USEC_PER_SEC + diff.tv_usec;
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# Executed %'u NOP requests in batches of %u%s\n\n",
+		       done, nr_batch, defer_taskrun ? ", DEFER_TASKRUN" : "");
+		printf(" %14s: %lu.%03lu [sec]\n\n", "Total time",
+		       (unsigned long)diff.tv_sec,
+		       (unsigned long)(diff.tv_usec / USEC_PER_MSEC));
+		printf(" %14lf usecs/op\n", (double)result_usec / (double)done);
+		printf(" %'14d ops/sec\n",
+		       (int)((double)done / ((double)result_usec / USEC_PER_SEC)));
+		break;
+
+	case BENCH_FORMAT_SIMPLE:
+		printf("%lu.%03lu\n", (unsigned long)diff.tv_sec,
+		       (unsigned long)(diff.tv_usec / USEC_PER_MSEC));
+		break;
+
+	default:
+		/* reaching here is something disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		exit(1);
+	}
+
+	return 0;
+}
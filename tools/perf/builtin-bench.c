@@ -16,6 +16,8 @@
  *  numa  ... NUMA scheduling and MM performance
  *  futex ... Futex performance
  *  epoll ... Event poll performance
+ *  fs    ... Page cache and readahead performance
+ *  uring ... io_uring submission and completion performance
  */
 #include <subcmd/parse-options.h>
 #include "builtin.h"
@@ -115,6 +117,20 @@ static struct bench uprobe_benchmarks[] = {
 	{ NULL,	NULL, NULL },
 };
 
+static struct bench fs_benchmarks[] = {
+	{ "seq-read",	"Benchmark for sequential buffered reads",	bench_fs_seq_read	},
+	{ "random-read", "Benchmark for random buffered reads",	bench_fs_random_read	},
+	{ "mmap-read",	"Benchmark for mmap() read faults",		bench_fs_mmap_read	},
+	{ "all",	"Run all fs benchmarks",			NULL			},
+	{ NULL,		NULL,						NULL			}
+};
+
+static struct bench uring_benchmarks[] = {
+	{ "nop",	"Benchmark for io_uring NOP submit and complete",	bench_uring_nop	},
+	{ "all",	"Run all io_uring benchmarks",			NULL			},
+	{ NULL,		NULL,						NULL			}
+};
+
 struct collection {
 	const char	*name;
 	const char	*summary;
@@ -135,6 +151,8 @@ static struct collection collections[] = {
 	{ "internals",	"Perf-internals benchmarks",			internals_benchmarks	},
 	{ "breakpoint",	"Breakpoint benchmarks",			breakpoint_benchmarks	},
 	{ "uprobe",	"uprobe benchmarks",				uprobe_benchmarks	},
+	{ "fs",		"Page cache and readahead benchmarks",		fs_benchmarks		},
+	{ "uring",	"io_uring benchmarks",				uring_benchmarks	},
 	{ "all",	"All benchmarks",				NULL			},
 	{ NULL,		NULL,						NULL			}
 };
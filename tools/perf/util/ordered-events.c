@@ -22,6 +22,7 @@ static void queue_event(struct ordered_events *oe, struct ordered_event *new)
 	struct list_head *p;
 
 	++oe->nr_events;
+	/* Every path below queues @new, including the tail fast path. */
 	oe->last = new;
 
 	pr_oe_time2(timestamp, "queue_event nr_events %u\n", oe->nr_events);
@@ -32,6 +33,17 @@ static void queue_event(struct ordered_events *oe, struct ordered_event *new)
 		return;
 	}
 
+	/*
+	 * The tail of the list always holds max_timestamp, so an event that
+	 * is not older than it (the common case for a mostly sorted stream)
+	 * goes straight to the tail without walking from the last position.
+	 */
+	if (timestamp >= oe->max_timestamp) {
+		list_add_tail(&new->list, &oe->events);
+		oe->max_timestamp = timestamp;
+		return;
+	}
+
 	/*
 	 * last event might point to some random place in the list as it's
 	 * the last queued event. We expect that the new event is close to